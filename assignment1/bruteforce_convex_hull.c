@@ -1,20 +1,20 @@
-#include <stdlib.h> // atoi, rand, malloc, realloc
+#include <stdlib.h> // atoi, strtoull, malloc, realloc, qsort
 #include <stdio.h>
 #include <time.h> //time
+#include <unistd.h> // getopt
+#include <string.h> // memcmp
+#include <pthread.h> // pthread_create, pthread_join (compile with -pthread)
+#include <stdatomic.h> // atomic_int, atomic_fetch_add
 
 #define RANGE 10000
 
-typedef struct
-{
-	int x;
-	int y;
-} t_point;
+static int range = RANGE; // 좌표의 범위 (-r), 32비트 정수 범위까지 가능
 
-typedef struct
-{
-	t_point from;
-	t_point to;
-} t_line;
+#include "../common/point.h" // t_point, t_line
+#include "../common/akl_toussaint.h" // akl_toussaint (link with ../common/hull_core.cpp, -lstdc++)
+#include "../common/orient.h" // orient2d_sign
+#include "../common/hull_io.h" // read_hull
+#include "../common/pointgen.h" // generate_points (link with -lm)
 
 ////////////////////////////////////////////////////////////////////////////////
 void print_header( char *filename)
@@ -22,7 +22,7 @@ void print_header( char *filename)
 	printf( "#! /usr/bin/env Rscript\n");
 	printf( "png(\"%s\", width=700, height=700)\n", filename);
 	
-	printf( "plot(1:%d, 1:%d, type=\"n\")\n", RANGE, RANGE);
+	printf( "plot(1:%d, 1:%d, type=\"n\")\n", range, range);
 }
 ////////////////////////////////////////////////////////////////////////////////
 void print_footer( void)
@@ -71,12 +71,11 @@ t_line *convex_hull( t_point *points, int num_point, int *num_line){
 	for(i=0;i<num_point;i++){
 		for(j=i+1; j<num_point; j++){
 		//	printf("come in! %d,%d / %d, %d\n", points[i].x, points[i].y, points[j].x, points[j].y);
-			int a = points[j].y-points[i].y;
-			int b = points[i].x-points[j].x;
-			int c = points[i].x * points[j].y - points[i].y*points[j].x;
 			int flag = 0;
 			for(int m=0; m<num_point; m++){
-				if(a*points[m].x + b*points[m].y > c){
+				// ax+by-c = -orient2d(points[i], points[j], points[m])
+				int side = -orient2d_sign(points[i], points[j], points[m]);
+				if(side > 0){
 					if(flag == 0 || flag == 1)
 						flag = 1;
 					else{
@@ -84,9 +83,9 @@ t_line *convex_hull( t_point *points, int num_point, int *num_line){
 						break;
 					}
 				}
-				else if(a*points[m].x + b*points[m].y == c)
+				else if(side == 0)
 					flag = 0;
-				else if(a*points[m].x + b*points[m].y < c){
+				else if(side < 0){
 					if(flag == 0 || flag == 2)
 						flag =2 ;
 					else{
@@ -107,20 +106,404 @@ t_line *convex_hull( t_point *points, int num_point, int *num_line){
 	return lines;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// 검증용(oracle) brute force
+// convex_hull과 같이 모든 (i, j) 쌍마다 나머지 점들이 한쪽에 있는지 보지만
+// - 같은 점들은 하나만 남기고
+// - 직선 i->j 의 양쪽에서 점을 보거나, 직선 위이지만 선분 i-j 밖의 점을 보면 바로 다음 쌍으로 넘어가며
+//   (점들을 섞어서 훑으므로 convex hull의 변이 아닌 쌍은 대개 몇 개의 점만 보고 끝남)
+// - i 마다 스레드에 나누어 주고, 나머지 점들의 방향 판정은 AVX2로 8개씩 한다.
+// 결과는 한 직선 위의 점들은 양 끝 점만 꼭짓점으로 하는 반시계 방향의 선들 (efficient_convex_hull의 엔진들과 같음)
+#define MAX_THREAD		256
+#define ORACLE_INT32_LIMIT	(1 << 14)	// 모든 좌표의 절댓값이 이보다 작으면 32비트 정수로 방향 판정 (곱 < 2^30)
+#define ORACLE_SHUFFLE_SEED	0x6f7261636c65ULL	// 점들을 섞는 순서 (고정되어 있으므로 실행 시간도 매번 같음)
+
+static int num_thread = 1; // 스레드의 수 (-t)
+
+#define SCAN_NONE	(-2)	// convex hull의 변이 아님
+
+// 점들(x[0] ~ x[n-1], y[0] ~ y[n-1])이 모두 직선 a->b 의 한쪽 또는 선분 a-b 위에 있는지 검사하는 커널
+// return value : +1 모두 왼쪽 또는 선분 위, -1 모두 오른쪽 또는 선분 위, 0 모두 선분 위, SCAN_NONE 그 외
+typedef int (*t_scan_kernel)( const int *x, const int *y, int n, t_point a, t_point b);
+
+// 점 p가 선분 a-b 를 대각선으로 하는 직사각형 밖에 있는지 (a, b, p 가 한 직선 위일 때는 선분 밖과 같음)
+static int out_of_box( t_point a, t_point b, t_point p)
+{
+	return (p.x < a.x && p.x < b.x) || (p.x > a.x && p.x > b.x) || (p.y < a.y && p.y < b.y) || (p.y > a.y && p.y > b.y);
+}
+
+static int scan_scalar( const int *x, const int *y, int n, t_point a, t_point b)
+{
+	int left = 0, right = 0;
+
+	for (int m = 0; m < n; m++)
+	{
+		t_point p = { x[m], y[m]};
+		int side = orient2d_sign( a, b, p);
+
+		if (side > 0)
+			left = 1;
+		else if (side < 0)
+			right = 1;
+		else if (out_of_box( a, b, p))
+			return SCAN_NONE;
+
+		if (left && right)
+			return SCAN_NONE;
+	}
+	return left - right;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define USE_AVX2
+#include <immintrin.h>
+
+// 모든 좌표의 절댓값이 ORACLE_INT32_LIMIT 보다 작을 때만 사용
+__attribute__((target("avx2")))
+static int scan_avx2( const int *x, const int *y, int n, t_point a, t_point b)
+{
+	__m256i ax = _mm256_set1_epi32( a.x), ay = _mm256_set1_epi32( a.y);
+	__m256i dx = _mm256_set1_epi32( b.x - a.x), dy = _mm256_set1_epi32( b.y - a.y);
+	__m256i minx = _mm256_set1_epi32( a.x < b.x ? a.x : b.x), maxx = _mm256_set1_epi32( a.x < b.x ? b.x : a.x);
+	__m256i miny = _mm256_set1_epi32( a.y < b.y ? a.y : b.y), maxy = _mm256_set1_epi32( a.y < b.y ? b.y : a.y);
+	__m256i zero = _mm256_setzero_si256();
+	__m256i left = zero, right = zero;
+	int m;
+
+	for (m = 0; m + 8 <= n; m += 8)
+	{
+		__m256i px = _mm256_sub_epi32( _mm256_loadu_si256( (const __m256i *)(x + m)), ax);
+		__m256i py = _mm256_sub_epi32( _mm256_loadu_si256( (const __m256i *)(y + m)), ay);
+		__m256i o = _mm256_sub_epi32( _mm256_mullo_epi32( dx, py), _mm256_mullo_epi32( dy, px));
+		__m256i pos = _mm256_cmpgt_epi32( o, zero);
+		__m256i neg = _mm256_cmpgt_epi32( zero, o);
+
+		// 직선 위(o == 0)이면서 선분 밖인 점
+		px = _mm256_add_epi32( px, ax);
+		py = _mm256_add_epi32( py, ay);
+		__m256i out = _mm256_or_si256(
+			_mm256_or_si256( _mm256_cmpgt_epi32( minx, px), _mm256_cmpgt_epi32( px, maxx)),
+			_mm256_or_si256( _mm256_cmpgt_epi32( miny, py), _mm256_cmpgt_epi32( py, maxy)));
+		__m256i bad = _mm256_andnot_si256( _mm256_or_si256( pos, neg), out);
+
+		left = _mm256_or_si256( left, pos);
+		right = _mm256_or_si256( right, neg);
+		if (!_mm256_testz_si256( bad, bad) || (!_mm256_testz_si256( left, left) && !_mm256_testz_si256( right, right)))
+			return SCAN_NONE;
+	}
+
+	int result = scan_scalar( x + m, y + m, n - m, a, b);
+	if (result == SCAN_NONE)
+		return SCAN_NONE;
+
+	int l = !_mm256_testz_si256( left, left) || result > 0;
+	int r = !_mm256_testz_si256( right, right) || result < 0;
+	return (l && r) ? SCAN_NONE : l - r;
+}
+#endif
+
+// 스레드마다의 작업
+typedef struct
+{
+	const int *x;
+	const int *y;
+	int n;
+	t_scan_kernel scan;
+	atomic_int *next;	// 다음에 처리할 i
+
+	t_line *lines;		// 찾은 선들
+	int num_line;
+	int capacity;
+} t_oracle_worker;
+
+static void add_line( t_oracle_worker *w, t_point from, t_point to)
+{
+	if (w->num_line == w->capacity)
+	{
+		w->capacity = (w->capacity == 0) ? 16 : w->capacity * 2;
+		w->lines = (t_line *) realloc( w->lines, w->capacity * sizeof(t_line));
+	}
+	w->lines[w->num_line++] = (t_line){ from, to};
+}
+
+static void *oracle_worker( void *arg)
+{
+	t_oracle_worker *w = (t_oracle_worker *) arg;
+	int i;
+
+	while ((i = atomic_fetch_add( w->next, 1)) < w->n)
+	{
+		t_point a = { w->x[i], w->y[i]};
+
+		for (int j = i + 1; j < w->n; j++)
+		{
+			t_point b = { w->x[j], w->y[j]};
+			int side = w->scan( w->x, w->y, w->n, a, b);
+
+			// 나머지 점들이 왼쪽에 있도록 (반시계 방향), 모든 점이 한 직선 위이면 양방향
+			if (side >= 0)
+				add_line( w, a, b);
+			if (side <= 0 && side != SCAN_NONE)
+				add_line( w, b, a);
+		}
+	}
+	return NULL;
+}
+
+// x, y 순서로 비교
+static int cmp_point( const void *p1, const void *p2)
+{
+	const t_point *p = (const t_point *) p1;
+	const t_point *q = (const t_point *) p2;
+
+	if (p->x != q->x)
+		return (p->x > q->x) - (p->x < q->x);
+	return (p->y > q->y) - (p->y < q->y);
+}
+
+// 선의 시작점, 끝점 순서로 비교
+static int cmp_line( const void *p1, const void *p2)
+{
+	const t_line *l1 = (const t_line *) p1;
+	const t_line *l2 = (const t_line *) p2;
+	int c = cmp_point( &l1->from, &l2->from);
+
+	return (c != 0) ? c : cmp_point( &l1->to, &l2->to);
+}
+
+// [input] points : set of points
+// [input] num_point : number of points
+// [output] num_line : number of line segments that forms the convex hull
+// return value : set of line segments that forms the convex hull (시작점, 끝점 순서로 정렬됨)
+t_line *convex_hull_oracle( t_point *points, int num_point, int *num_line)
+{
+	// 같은 점들을 하나로
+	t_point *sorted = (t_point *) malloc( num_point * sizeof(t_point));
+	memcpy( sorted, points, num_point * sizeof(t_point));
+	qsort( sorted, num_point, sizeof(t_point), cmp_point);
+
+	int n = 0;
+	for (int i = 0; i < num_point; i++)
+		if (n == 0 || cmp_point( &sorted[n-1], &sorted[i]) != 0)
+			sorted[n++] = sorted[i];
+
+	// x, y 순서로 훑으면 왼쪽의 점들이 모두 직선의 한쪽에 있는 경우가 많아 일찍 끝나지 않으므로 섞어서 저장
+	for (int i = n - 1; i > 0; i--)
+	{
+		uint32_t counter[4] = { (uint32_t) i, 0, 0, 0};
+		uint32_t u[4];
+
+		philox4x32( counter, ORACLE_SHUFFLE_SEED, u);
+		int j = (int)(((uint64_t) u[0] * (uint32_t)(i + 1)) >> 32);
+		t_point tmp = sorted[i];
+		sorted[i] = sorted[j];
+		sorted[j] = tmp;
+	}
+
+	int *x = (int *) malloc( 2 * n * sizeof(int));
+	int *y = x + n;
+	int small = 1;
+	for (int i = 0; i < n; i++)
+	{
+		x[i] = sorted[i].x;
+		y[i] = sorted[i].y;
+		small &= (x[i] > -ORACLE_INT32_LIMIT && x[i] < ORACLE_INT32_LIMIT && y[i] > -ORACLE_INT32_LIMIT && y[i] < ORACLE_INT32_LIMIT);
+	}
+
+	t_scan_kernel scan = scan_scalar;
+#ifdef USE_AVX2
+	__builtin_cpu_init();
+	if (small && __builtin_cpu_supports( "avx2"))
+		scan = scan_avx2;
+#endif
+
+	atomic_int next = 0;
+	pthread_t threads[MAX_THREAD];
+	t_oracle_worker workers[MAX_THREAD];
+
+	for (int t = 0; t < num_thread; t++)
+	{
+		workers[t] = (t_oracle_worker){ x, y, n, scan, &next, NULL, 0, 0};
+		if (t > 0)
+			pthread_create( &threads[t], NULL, oracle_worker, &workers[t]);
+	}
+	oracle_worker( &workers[0]);
+
+	int total = 0;
+	for (int t = 0; t < num_thread; t++)
+	{
+		if (t > 0)
+			pthread_join( threads[t], NULL);
+		total += workers[t].num_line;
+	}
+
+	// 점이 하나이면 efficient_convex_hull과 같이 (p, p) 두 개
+	t_line *lines = (t_line *) malloc( (total + 2) * sizeof(t_line));
+	*num_line = 0;
+	if (n == 1)
+	{
+		lines[0] = lines[1] = (t_line){ sorted[0], sorted[0]};
+		*num_line = 2;
+	}
+	for (int t = 0; t < num_thread; t++)
+	{
+		memcpy( lines + *num_line, workers[t].lines, workers[t].num_line * sizeof(t_line));
+		*num_line += workers[t].num_line;
+		free( workers[t].lines);
+	}
+	qsort( lines, *num_line, sizeof(t_line), cmp_line);
+
+	free( sorted);
+	free( x);
+	return lines;
+}
+
+// 바이너리 파일(efficient_convex_hull -o bin)의 convex hull을 oracle로 검증
+// 파일의 모든 점으로 oracle이 구한 선들과 파일의 꼭짓점들을 이은 선들을 비교
+// [input] prefilter : 1이면 점들을 Akl-Toussaint로 줄인 뒤 oracle 실행 (-f)
+//                     빠르지만 엔진들의 -f와 같은 코드(common/hull_core.cpp)를 거치므로 그만큼 독립적인 검증은 아님
+// return value : 0 일치, 1 불일치 또는 파일 오류
+static int verify_file( const char *filename, int prefilter)
+{
+	t_point *points;
+	int *hull;
+	int num_point, num_hull;
+
+	if (read_hull( filename, &points, &num_point, &hull, &num_hull) < 0)
+	{
+		fprintf( stderr, "%s: not a convex hull file!\n", filename);
+		return 1;
+	}
+	fprintf( stderr, "%d points, %d hull vertices read!\n", num_point, num_hull);
+
+	int result = 0;
+	int num_expected = (num_hull == 1) ? 2 : num_hull;
+	t_line *expected = (t_line *) malloc( (num_expected + 1) * sizeof(t_line));
+
+	for (int i = 0; i < num_hull; i++)
+	{
+		if (hull[i] < 0 || hull[i] >= num_point || hull[(i+1) % num_hull] < 0 || hull[(i+1) % num_hull] >= num_point)
+		{
+			fprintf( stderr, "hull index out of range!\n");
+			result = 1;
+			break;
+		}
+		expected[i] = (t_line){ points[hull[i]], points[hull[(i+1) % num_hull]]};
+	}
+	if (num_hull == 1)
+		expected[1] = expected[0];
+
+	if (result == 0)
+	{
+		qsort( expected, num_expected, sizeof(t_line), cmp_line);
+
+		int num_line;
+		int num_input = (prefilter && num_point > 0) ? akl_toussaint( points, num_point) : num_point;
+		t_line *lines = convex_hull_oracle( points, num_input, &num_line);
+
+		if (num_line != num_expected || memcmp( lines, expected, num_line * sizeof(t_line)) != 0)
+		{
+			fprintf( stderr, "mismatch! (oracle %d lines, file %d lines)\n", num_line, num_expected);
+			result = 1;
+		}
+		else
+			fprintf( stderr, "verified! (%d lines)\n", num_line);
+		free( lines);
+	}
+
+	free( expected);
+	free( points);
+	free( hull);
+	return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void print_usage( char *program)
+{
+	printf( "%s [-f] [-r range] [-S seed] [-g distribution] [-p] [-t number_of_threads] number_of_points\n", program);
+	printf( "%s [-f] [-t number_of_threads] -v hull_file\n", program);
+	printf( "distributions:");
+	for (int i = 0; i < POINTGEN_NUM_DIST; i++)
+		printf( " %s", pointgen_names[i]);
+	printf( "\n");
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int main( int argc, char **argv)
 {
-	int x, y;
 	int num_point; // number of points
 	int num_line; // number of lines
 	
-	if (argc != 2)
+	uint64_t seed = time( NULL); // 점 생성의 seed (-S)
+	int distribution = POINTGEN_UNIFORM; // 점의 분포 (-g)
+	int prefilter = 0; // Akl-Toussaint 전처리 (-f)
+	int oracle = 0; // 검증용 brute force 사용 (-p)
+	char *verify = NULL; // 검증할 바이너리 파일 (-v)
+	int opt;
+
+	while ((opt = getopt( argc, argv, "fr:pt:v:S:g:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'S':
+				seed = strtoull( optarg, NULL, 0);
+				break;
+			case 'g':
+				distribution = find_distribution( optarg);
+				if (distribution < 0)
+				{
+					printf( "Unknown distribution: %s\n", optarg);
+					return 0;
+				}
+				break;
+			case 'p':
+				oracle = 1;
+				break;
+			case 't':
+				num_thread = atoi( optarg);
+				if (num_thread < 1 || num_thread > MAX_THREAD)
+				{
+					printf( "The number of threads should be between 1 and %d!\n", MAX_THREAD);
+					return 0;
+				}
+				break;
+			case 'v':
+				verify = optarg;
+				break;
+			case 'f':
+				prefilter = 1;
+				break;
+			case 'r':
+				range = atoi( optarg);
+				if (range <= 0)
+				{
+					printf( "The range should be a positive integer!\n");
+					return 0;
+				}
+				break;
+			default:
+				print_usage( argv[0]);
+				return 0;
+		}
+	}
+
+	if (verify != NULL)
+	{
+		if (optind != argc)
+		{
+			print_usage( argv[0]);
+			return 0;
+		}
+		return verify_file( verify, prefilter);
+	}
+
+	if (optind != argc - 1)
 	{
-		printf( "%s number_of_points\n", argv[0]);
+		print_usage( argv[0]);
 		return 0;
 	}
 
-	num_point = atoi( argv[1]);
+	num_point = atoi( argv[optind]);
 	if (num_point <= 0)
 	{
 		printf( "The number of points should be a positive integer!\n");
@@ -131,24 +514,23 @@ int main( int argc, char **argv)
 		
 	t_line *lines;
 
-	// making n points
-	srand( time(NULL));
-	for (int i = 0; i < num_point; i++)
-	{
-		x = rand() % RANGE + 1; // 1 ~ RANGE random number
-		y = rand() % RANGE + 1;
-		
-		points[i].x = x;
-		points[i].y = y;
- 	}
+	// making n points (1 ~ range, efficient_convex_hull과 같은 seed, 분포이면 같은 점들)
+	generate_points( points, num_point, distribution, seed, POINTGEN_STREAM_POINT, range, num_thread);
 
-	fprintf( stderr, "%d points created!\n", num_point);
+	fprintf( stderr, "%d points created! (seed %llu)\n", num_point, (unsigned long long) seed);
 
 	print_header( "convex.png");
 	
 	print_points( points, num_point);
 	
-	lines = convex_hull( points, num_point, &num_line);
+	// convex hull의 점이 될 수 없는 점들을 미리 제거
+	if (prefilter)
+	{
+		num_point = akl_toussaint( points, num_point);
+		fprintf( stderr, "%d points survived the prefilter!\n", num_point);
+	}
+	
+	lines = oracle ? convex_hull_oracle( points, num_point, &num_line) : convex_hull( points, num_point, &num_line);
 
 	fprintf( stderr, "%d lines created!\n", num_line);
 
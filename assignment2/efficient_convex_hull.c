@@ -1,22 +1,26 @@
-#include <stdlib.h> // atoi, rand, qsort, malloc
+#include <stdlib.h> // atoi, strtoull, qsort, malloc
 #include <stdio.h>
 #include <assert.h> // assert
-#include <time.h> //time
+#include <time.h> //time, clock_gettime
+#include <string.h> // strcmp
+#include <unistd.h> // getopt, fork, execl, pipe
+#include <pthread.h> // pthread_create, pthread_join, pthread_mutex_lock, pthread_cond_wait (compile with -pthread)
+#include <stdatomic.h> // atomic_int, atomic_fetch_add
+#include <math.h> // sqrt (link with -lm)
+#include <sys/wait.h> // wait4
+#include <sys/resource.h> // struct rusage
 
 #define RANGE 10000
 
-typedef struct
-{
-	int x;
-	int y;
-} t_point;
+static int range = RANGE; // 좌표의 범위 (-r), 32비트 정수 범위까지 가능
 
-typedef struct
-{
-	t_point from;
-	t_point to;
-} t_line;
-float distance( float a, float b, float c, t_point p);
+#include "../common/point.h" // t_point, t_line
+#include "../common/akl_toussaint.h" // akl_toussaint
+#include "../common/hull_core.h" // hull_core_chain, hull_core_int (link with ../common/hull_core.cpp, -lstdc++)
+#include "../common/orient.h" // orient2d, orient2d_sign, dist2
+#include "../common/hull_io.h" // write_hull
+#include "../common/pointgen.h" // generate_points
+t_wide distance( t_point from, t_point to, t_point p);
 void separate_points( t_point *points, int num_point, t_point from, t_point to, t_point *s1, t_point *s2, int *n1, int *n2);
 
 
@@ -29,8 +33,10 @@ void separate_points( t_point *points, int num_point, t_point from, t_point to,
 // return value: 선들의 집합(lines)에 대한 포인터
 t_line *upper_hull( t_point *points, int num_point, t_point p1, t_point pn, t_line *lines, int *num_line, int *capacity){
   if((*capacity) < (*num_line)+1){
-	(*capacity) += 10;
+	// 두 배씩 늘려서 realloc에 의한 복사가 전체 O(h)가 되도록
+	(*capacity) *= 2;
     lines = (t_line*) realloc(lines, (*capacity) * sizeof(t_line));
+	assert( lines != NULL);
 	//printf("\n realloc! \n");
   }
   if(num_point == 0){
@@ -43,13 +49,10 @@ t_line *upper_hull( t_point *points, int num_point, t_point p1, t_point pn, t_li
   }
   
   else {
-	  float a = pn.y - p1.y;
-	  float b = p1.x - pn.x;
-	  float c = p1.x * pn.y - p1.y * pn.x;
-	  float max = 0;
+	  t_wide max = 0;
 	  t_point maxp;
 	  for(int i=0; i < num_point; i++){
-		  float dist =  distance(a, b, c, points[i]) ;
+		  t_wide dist =  distance(p1, pn, points[i]) ;
 		  if(max < dist){
 			max = dist;
 			maxp = points[i];
@@ -76,14 +79,12 @@ t_line *upper_hull( t_point *points, int num_point, t_point p1, t_point pn, t_li
   }
 }
 
-// 직선(ax+by-c=0)과 주어진 점 p(x1, y1) 간의 거리
+// 두 점(from, to)을 잇는 직선(ax+by-c=0)과 주어진 점 p(x1, y1) 간의 거리
 // distance = |ax1+by1-c| / sqrt(a^2 + b^2)
-// 실제로는 sqrt는 계산하지 않음
+// 실제로는 sqrt는 계산하지 않음 (|ax1+by1-c| 는 orient2d의 절댓값과 같으며 정확하게 계산됨)
 // return value: 직선과 점 사이의 거리 (분모 제외)
-float distance( float a, float b, float c, t_point p){
-  float x = p.x;
-  float y = p.y;
-  float result = a*x + b*y - c;
+t_wide distance( t_point from, t_point to, t_point p){
+  t_wide result = orient2d(from, to, p);
   return (result>0?result:-result);
 }
 
@@ -93,19 +94,14 @@ float distance( float a, float b, float c, t_point p){
 // [output] n1 : s1 집합에 속한 점의 수
 // [output] n2 : s2 집합에 속한 점의 수
 void separate_points( t_point *points, int num_point, t_point from, t_point to, t_point *s1, t_point *s2, int *n1, int *n2){
-  int x1 = from.x;
-  int y1 = from.y;
-  int x2 = to.x;
-  int y2 = to.y;
-  int a = y2 - y1;
-  int b = x1- x2;
-  int c = x1*y2-y1*x2; 
   *n1 = 0; *n2 = 0; 
   
+  // ax+by-c = -orient2d(from, to, p)
   for(int i = 0; i<num_point; i++){
-	  if(a*points[i].x + b*points[i].y < c)
+	  int side = orient2d_sign(from, to, points[i]);
+	  if(side > 0)
 	    s1[(*n1)++]= points[i];
-	  else if (a*points[i].x + b*points[i].y > c)
+	  else if (side < 0)
 	    s2[(*n2)++] = points[i];
   }
   //printf("\nupper");
@@ -121,7 +117,7 @@ void print_header(char *filename)
 	printf( "#! /usr/bin/env Rscript\n");
 	printf( "png(\"%s\", width=700, height=700)\n", filename);
 	
-	printf( "plot(1:%d, 1:%d, type=\"n\")\n", RANGE, RANGE);
+	printf( "plot(1:%d, 1:%d, type=\"n\")\n", range, range);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -132,14 +128,16 @@ void print_footer(void)
 
 ////////////////////////////////////////////////////////////////////////////////
 // qsort를 위한 비교 함수
+// x 좌표가 같으면 y 좌표로 비교 (points[0], points[num_point-1]이 convex hull의 꼭짓점이 되도록)
 int cmp_x( const void *p1, const void *p2)
 {
 	t_point *p = (t_point *)p1;
 	t_point *q = (t_point *)p2;
 	
-	float diff = p->x - q->x;
+	if (p->x != q->x)
+		return (p->x > q->x) ? +1 : -1;
 	
-    return ((diff >= 0.0) ? ((diff > 0.0) ? +1 : 0) : -1);
+	return (p->y > q->y) - (p->y < q->y);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -203,57 +201,3411 @@ t_line *convex_hull( t_point *points, int num_point, int *num_line)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-int main( int argc, char **argv)
+// 제자리(in-place) quickhull의 부분 문제
+// points[lo] ~ points[hi-1] 의 점들은 모두 직선 p1->pn 의 upper(left)에 있음
+typedef struct
 {
-	float x, y;
-	int num_point; // number of points
-	
-	if (argc != 2)
+	t_point p1;
+	t_point pn;
+	int lo;
+	int hi;
+} t_hull_task;
+
+// 점 p가 직선 from->to 의 upper(left)에 있는지 검사 (ax+by-c < 0)
+// return value: 1 upper(left)에 있는 경우, 0 그 외
+static int is_upper( t_point from, t_point to, t_point p)
+{
+	return (orient2d_sign( from, to, p) > 0);
+}
+
+// points[lo] ~ points[hi-1] 을 quicksort의 분할처럼 제자리에서 세 구간으로 나누는 함수
+// [lo, *mid) : 직선 from1->to1 의 upper(left)에 속한 점들
+// [*mid, *end) : 직선 from2->to2 의 upper(left)에 속한 점들
+// [*end, hi) : 나머지 점들 (더 이상 필요 없음)
+static void partition_points( t_point *points, int lo, int hi, t_point from1, t_point to1, t_point from2, t_point to2, int *mid, int *end)
+{
+	int a = lo; // [lo, a) : 첫 번째 집합
+	int i = lo; // [a, i) : 두 번째 집합
+	int b = hi; // [b, hi) : 나머지
+	t_point tmp;
+
+	while (i < b)
 	{
-		printf( "%s number_of_points\n", argv[0]);
-		return 0;
+		if (is_upper( from1, to1, points[i]))
+		{
+			tmp = points[a]; points[a] = points[i]; points[i] = tmp;
+			a++; i++;
+		}
+		else if (is_upper( from2, to2, points[i]))
+			i++;
+		else
+		{
+			b--;
+			tmp = points[b]; points[b] = points[i]; points[i] = tmp;
+		}
+	}
+	*mid = a;
+	*end = b;
+}
+
+// 점 p가 점 q보다 (x, y) 사전식 순서로 앞에 있는지 검사
+static int is_before( t_point p, t_point q)
+{
+	return (p.x < q.x || (p.x == q.x && p.y < q.y));
+}
+
+// 직선 p1->pn 으로부터 가장 먼 점을 찾는 함수 (points[lo] ~ points[hi-1])
+// 같은 거리의 점이 여럿이면 (x, y) 순서로 가장 앞의 점을 선택
+// (직선에 평행한 선 위의 양 끝 점 중 하나이므로, 그 사이의 점은 convex hull에 들어가지 않음)
+// return value : 가장 먼 점의 index
+static int farthest_point( t_point *points, int lo, int hi, t_point p1, t_point pn)
+{
+	t_wide max = 0;
+	int maxi = lo;
+
+	for (int i = lo; i < hi; i++)
+	{
+		t_wide dist = orient2d( p1, pn, points[i]);
+		if (max < dist || (max == dist && dist > 0 && is_before( points[i], points[maxi])))
+		{
+			max = dist;
+			maxi = i;
+		}
 	}
+	return maxi;
+}
 
-	num_point = atoi( argv[1]);
-	if (num_point <= 0)
+// 작업 스택(stack)에 쌓인 부분 문제들을 모두 처리하는 함수
+// 스택에는 부분 문제의 점의 수 + 2 개 만큼의 공간이 있어야 함
+// [output] lines : convex hull을 이루는 선들 (부분 문제의 점의 수 + 2 개 만큼의 공간이 있어야 함)
+// return value : lines에 저장된 선의 수
+static int run_hull_tasks( t_point *points, t_hull_task *stack, int top, t_line *lines)
+{
+	int num_line = 0;
+	int mid, end;
+
+	while (top > 0)
 	{
-		printf( "The number of points should be a positive integer!\n");
-		return 0;
+		t_hull_task task = stack[--top];
+
+		if (task.lo == task.hi)
+		{
+			lines[num_line].from = task.p1;
+			lines[num_line].to = task.pn;
+			num_line++;
+			continue;
+		}
+
+		t_point maxp = points[farthest_point( points, task.lo, task.hi, task.p1, task.pn)];
+
+		partition_points( points, task.lo, task.hi, task.p1, maxp, maxp, task.pn, &mid, &end);
+
+		// p1->maxp 를 먼저 처리하도록 maxp->pn 을 먼저 쌓는다.
+		stack[top++] = (t_hull_task){ maxp, task.pn, mid, end};
+		stack[top++] = (t_hull_task){ task.p1, maxp, task.lo, mid};
 	}
+	return num_line;
+}
+
+// 제자리 quickhull
+// upper_hull과 같은 결과를 구하지만 재귀호출 대신 작업 스택(stack)을 사용하고
+// 부분 집합을 새로 할당하지 않고 points 배열을 제자리에서 분할함 (points의 순서가 바뀜)
+// 출력 버퍼와 작업 스택을 처음에 한 번만 할당하며 이후에는 메모리 할당이 없음
+// [input] points : set of points (x 좌표에 따라 정렬된 상태)
+// [input] num_point : number of points
+// [output] num_line : number of lines
+// return value : pointer of set of line segments that forms the convex hull
+t_line *convex_hull_inplace( t_point *points, int num_point, int *num_line)
+{
+	// convex hull의 선의 수와 스택에 쌓이는 작업의 수는 점의 수 + 2 를 넘지 않음
+	t_line *lines = (t_line *) malloc( (num_point + 2) * sizeof(t_line));
+	assert( lines != NULL);
+
+	t_hull_task *stack = (t_hull_task *) malloc( (num_point + 2) * sizeof(t_hull_task));
+	assert( stack != NULL);
+
+	int mid, end;
+
+	t_point p1 = points[0];
+	t_point pn = points[num_point-1];
+
+	// upper: [0, mid), lower: [mid, end)
+	partition_points( points, 0, num_point, p1, pn, pn, p1, &mid, &end);
+
+	// upper hull을 먼저 처리하도록 lower hull을 먼저 쌓는다.
+	stack[0] = (t_hull_task){ pn, p1, mid, end};
+	stack[1] = (t_hull_task){ p1, pn, 0, mid};
+
+	*num_line = run_hull_tasks( points, stack, 2, lines);
+
+	free( stack);
 
+	return lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 병렬 quickhull (work-stealing)
+// 각 스레드는 자신의 작업 큐(deque)의 뒤에서 작업을 꺼내고, 자신의 큐가 비면 다른 스레드 큐의 앞(가장 오래된, 큰 작업)에서 훔쳐온다.
+// 점의 수가 PAR_TASK_CUTOFF 보다 작은 부분 문제는 한 스레드가 run_hull_tasks로 끝까지 처리
+// 점의 수가 PAR_SCAN_CUTOFF 보다 큰 부분 문제는 가장 먼 점 탐색과 분할을 구간으로 나누어 게시하고, 쉬고 있는 worker들이 함께 처리
+// 할 일이 없는 worker는 조건 변수에서 기다림 (작업이 큐에 들어오거나, 탐색이 게시되거나, 모든 작업이 끝나면 깨어남)
+#define PAR_TASK_CUTOFF	4096
+#define PAR_SCAN_CUTOFF	(1 << 20)
+#define MAX_THREAD		256
+
+static int num_thread = 1; // 사용할 스레드의 수 (-t)
+
+typedef struct
+{
+	t_hull_task *tasks;
+	int head;		// 다른 스레드가 훔쳐가는 쪽
+	int tail;		// 자신이 넣고 꺼내는 쪽
+	int capacity;
+	pthread_mutex_t lock;
+} t_deque;
+
+// 병렬 탐색/분할에서 한 구간
+typedef struct
+{
 	t_point *points;
-	points = (t_point *)malloc( sizeof(t_point) * num_point);
-	assert( points != NULL);
-	
-	// making points
-	srand( time(NULL));
-	for (int i = 0; i < num_point; i++)
+	t_point *scratch;
+	unsigned char *side;
+	int lo, hi;
+	t_point from1, to1, from2, to2;
+	int maxi;					// farthest: 구간에서 가장 먼 점의 index
+	int count[3];				// classify: 각 집합에 속한 점의 수
+	int offset[3];				// scatter: 각 집합이 scratch에 저장될 위치
+} t_scan_job;
+
+// worker들이 함께 처리하는 탐색/분할 단계 (func가 NULL이면 게시된 단계가 없음)
+typedef struct
+{
+	void *(*func)(void *);
+	t_scan_job *jobs;
+	int num_job;
+	int next;		// 다음에 맡을 구간
+	int done;		// 끝난 구간의 수
+} t_scan;
+
+typedef struct
+{
+	t_point *points;
+	t_point *scratch;		// 병렬 분할을 위한 임시 버퍼 (점의 수 만큼)
+	unsigned char *side;	// 병렬 분할에서 각 점이 속한 집합
+	t_line *lines;
+	atomic_int num_line;
+	atomic_int pending;		// 큐에 있거나 처리 중인 작업의 수
+	t_deque deques[MAX_THREAD];
+
+	pthread_mutex_t lock;	// queued, scan을 보호
+	pthread_cond_t wake;	// 쉬고 있는 worker를 깨움
+	pthread_cond_t scan_done;	// 게시한 단계의 모든 구간이 끝남
+	int queued;				// 큐에 있는 작업의 수
+	t_scan scan;
+	pthread_mutex_t scan_owner;	// 탐색/분할을 게시할 수 있는 worker는 한 번에 하나
+} t_par_hull;
+
+typedef struct
+{
+	t_par_hull *ph;
+	int id;
+} t_worker;
+
+static void deque_push( t_deque *dq, t_hull_task task)
+{
+	pthread_mutex_lock( &dq->lock);
+	if (dq->tail == dq->capacity)
 	{
-		x = rand() % RANGE + 1; // 1 ~ RANGE random number
-		y = rand() % RANGE + 1;
-	
-		points[i].x = x;
-		points[i].y = y;
- 	}
+		if (dq->head > 0)
+		{
+			memmove( dq->tasks, dq->tasks + dq->head, (dq->tail - dq->head) * sizeof(t_hull_task));
+			dq->tail -= dq->head;
+			dq->head = 0;
+		}
+		else
+		{
+			dq->capacity *= 2;
+			dq->tasks = (t_hull_task *) realloc( dq->tasks, dq->capacity * sizeof(t_hull_task));
+			assert( dq->tasks != NULL);
+		}
+	}
+	dq->tasks[dq->tail++] = task;
+	pthread_mutex_unlock( &dq->lock);
+}
 
-	fprintf( stderr, "%d points created!\n", num_point);
-	
-	// sort the points by their x coordinate
-	qsort( points, num_point, sizeof(t_point), cmp_x);
+// from_head가 1이면 앞(steal), 0이면 뒤(pop)에서 작업을 꺼냄
+// return value : 1 작업을 꺼낸 경우, 0 큐가 빈 경우
+static int deque_take( t_deque *dq, t_hull_task *task, int from_head)
+{
+	int found = 0;
 
-	print_header( "convex.png");
-	
-	print_points( points, num_point);
-	
-	// convex hull algorithm
-	int num_line;
-	t_line *lines = convex_hull( points, num_point, &num_line);
-	
-	fprintf( stderr, "%d lines created!\n", num_line);
+	pthread_mutex_lock( &dq->lock);
+	if (dq->head < dq->tail)
+	{
+		*task = from_head ? dq->tasks[dq->head++] : dq->tasks[--dq->tail];
+		found = 1;
+	}
+	pthread_mutex_unlock( &dq->lock);
+	return found;
+}
 
-	print_line_segments( lines, num_line);
-	
-	print_footer();
+// 작업을 큐에 넣고 쉬고 있는 worker 하나를 깨움
+static void push_task( t_par_hull *ph, t_deque *dq, t_hull_task task)
+{
+	deque_push( dq, task);
+	pthread_mutex_lock( &ph->lock);
+	ph->queued++;
+	pthread_cond_signal( &ph->wake);
+	pthread_mutex_unlock( &ph->lock);
+}
+
+// 작업 하나가 끝남, 마지막 작업이면 기다리는 worker들을 모두 깨워 끝내게 함
+static void finish_task( t_par_hull *ph)
+{
+	if (atomic_fetch_sub( &ph->pending, 1) == 1)
+	{
+		pthread_mutex_lock( &ph->lock);
+		pthread_cond_broadcast( &ph->wake);
+		pthread_mutex_unlock( &ph->lock);
+	}
+}
+
+// 게시된 단계에서 남은 구간 하나를 맡아 처리 (ph->lock을 잡은 상태에서 호출)
+// return value : 1 구간을 처리한 경우, 0 남은 구간이 없는 경우
+static int help_scan( t_par_hull *ph)
+{
+	t_scan *scan = &ph->scan;
+
+	if (scan->func == NULL || scan->next == scan->num_job)
+		return 0;
+
+	void *(*func)(void *) = scan->func;
+	t_scan_job *job = &scan->jobs[scan->next++];
+
+	pthread_mutex_unlock( &ph->lock);
+	func( job);
+	pthread_mutex_lock( &ph->lock);
+
+	if (++scan->done == scan->num_job)
+		pthread_cond_signal( &ph->scan_done);
+	return 1;
+}
+
+// 구간 num_job 개로 나눈 단계를 게시하고, 다른 worker들과 함께 처리한 뒤 모두 끝날 때까지 기다림
+// scan_owner를 잡은 worker만 호출
+static void run_scan( t_par_hull *ph, void *(*func)(void *), t_scan_job *jobs, int num_job)
+{
+	pthread_mutex_lock( &ph->lock);
+	ph->scan = (t_scan){ func, jobs, num_job, 0, 0};
+	pthread_cond_broadcast( &ph->wake);
+
+	while (help_scan( ph))
+		;
+	while (ph->scan.done < num_job)
+		pthread_cond_wait( &ph->scan_done, &ph->lock);
+	ph->scan.func = NULL;
+	pthread_mutex_unlock( &ph->lock);
+}
+
+static void split_scan_jobs( t_scan_job *jobs, int num_job, int lo, int hi)
+{
+	long long len = hi - lo;
+
+	for (int i = 0; i < num_job; i++)
+	{
+		jobs[i].lo = lo + (int)(len * i / num_job);
+		jobs[i].hi = lo + (int)(len * (i + 1) / num_job);
+	}
+}
+
+static void *farthest_job( void *arg)
+{
+	t_scan_job *job = (t_scan_job *) arg;
+
+	job->maxi = farthest_point( job->points, job->lo, job->hi, job->from1, job->to1);
+	return NULL;
+}
+
+// farthest_point를 worker들이 나누어 처리
+static int farthest_point_par( t_par_hull *ph, int lo, int hi, t_point p1, t_point pn)
+{
+	t_scan_job jobs[MAX_THREAD];
+	t_point *points = ph->points;
+	int maxi = lo;
+	t_wide max = 0;
+
+	split_scan_jobs( jobs, num_thread, lo, hi);
+	for (int i = 0; i < num_thread; i++)
+	{
+		jobs[i].points = points;
+		jobs[i].from1 = p1;
+		jobs[i].to1 = pn;
+	}
+	run_scan( ph, farthest_job, jobs, num_thread);
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		if (jobs[i].lo == jobs[i].hi) continue;
+
+		t_point p = points[jobs[i].maxi];
+		t_wide dist = orient2d( p1, pn, p);
+		if (max < dist || (max == dist && dist > 0 && is_before( p, points[maxi])))
+		{
+			max = dist;
+			maxi = jobs[i].maxi;
+		}
+	}
+	return maxi;
+}
+
+static void *classify_job( void *arg)
+{
+	t_scan_job *job = (t_scan_job *) arg;
+
+	job->count[0] = job->count[1] = job->count[2] = 0;
+	for (int i = job->lo; i < job->hi; i++)
+	{
+		int k = is_upper( job->from1, job->to1, job->points[i]) ? 0 : (is_upper( job->from2, job->to2, job->points[i]) ? 1 : 2);
+		job->side[i] = k;
+		job->count[k]++;
+	}
+	return NULL;
+}
+
+static void *scatter_job( void *arg)
+{
+	t_scan_job *job = (t_scan_job *) arg;
+
+	for (int i = job->lo; i < job->hi; i++)
+		job->scratch[job->offset[job->side[i]]++] = job->points[i];
+	return NULL;
+}
+
+static void *copy_job( void *arg)
+{
+	t_scan_job *job = (t_scan_job *) arg;
+
+	memcpy( job->points + job->lo, job->scratch + job->lo, (job->hi - job->lo) * sizeof(t_point));
+	return NULL;
+}
+
+// partition_points를 worker들이 나누어 처리 (ph->scratch, ph->side는 points와 같은 크기의 임시 버퍼)
+static void partition_points_par( t_par_hull *ph, int lo, int hi, t_point from1, t_point to1, t_point from2, t_point to2, int *mid, int *end)
+{
+	t_scan_job jobs[MAX_THREAD];
+	int offset[3];
+
+	split_scan_jobs( jobs, num_thread, lo, hi);
+	for (int i = 0; i < num_thread; i++)
+	{
+		jobs[i].points = ph->points;
+		jobs[i].scratch = ph->scratch;
+		jobs[i].side = ph->side;
+		jobs[i].from1 = from1; jobs[i].to1 = to1;
+		jobs[i].from2 = from2; jobs[i].to2 = to2;
+	}
+	run_scan( ph, classify_job, jobs, num_thread);
+
+	// 각 집합의 시작 위치
+	offset[0] = lo;
+	offset[1] = offset[2] = 0;
+	for (int i = 0; i < num_thread; i++)
+	{
+		offset[1] += jobs[i].count[0];
+		offset[2] += jobs[i].count[1];
+	}
+	offset[1] += lo;
+	offset[2] += offset[1];
+	*mid = offset[1];
+	*end = offset[2];
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			jobs[i].offset[k] = offset[k];
+			offset[k] += jobs[i].count[k];
+		}
+	}
+	run_scan( ph, scatter_job, jobs, num_thread);
+	run_scan( ph, copy_job, jobs, num_thread);
+}
+
+// 부분 문제 하나를 처리
+// 작은 부분 문제는 local_stack, local_lines를 사용하여 끝까지 처리하고, 큰 부분 문제는 분할하여 큐에 넣는다.
+// 다른 worker가 이미 탐색/분할을 게시하고 있으면 큰 부분 문제도 혼자 처리
+static void run_par_task( t_par_hull *ph, t_deque *dq, t_hull_task task, t_hull_task *local_stack, t_line *local_lines)
+{
+	int n = task.hi - task.lo;
+	int mid, end;
+
+	if (n < PAR_TASK_CUTOFF)
+	{
+		local_stack[0] = task;
+		int count = run_hull_tasks( ph->points, local_stack, 1, local_lines);
+		int base = atomic_fetch_add( &ph->num_line, count);
+		memcpy( ph->lines + base, local_lines, count * sizeof(t_line));
+		return;
+	}
+
+	t_point maxp;
+
+	if (n > PAR_SCAN_CUTOFF && num_thread > 1 && pthread_mutex_trylock( &ph->scan_owner) == 0)
+	{
+		maxp = ph->points[farthest_point_par( ph, task.lo, task.hi, task.p1, task.pn)];
+		partition_points_par( ph, task.lo, task.hi, task.p1, maxp, maxp, task.pn, &mid, &end);
+		pthread_mutex_unlock( &ph->scan_owner);
+	}
+	else
+	{
+		maxp = ph->points[farthest_point( ph->points, task.lo, task.hi, task.p1, task.pn)];
+		partition_points( ph->points, task.lo, task.hi, task.p1, maxp, maxp, task.pn, &mid, &end);
+	}
+
+	atomic_fetch_add( &ph->pending, 2);
+	push_task( ph, dq, (t_hull_task){ maxp, task.pn, mid, end});
+	push_task( ph, dq, (t_hull_task){ task.p1, maxp, task.lo, mid});
+}
+
+static void *par_worker( void *arg)
+{
+	t_worker *w = (t_worker *) arg;
+	t_par_hull *ph = w->ph;
+	t_deque *dq = &ph->deques[w->id];
+	t_hull_task task;
+
+	t_hull_task *local_stack = (t_hull_task *) malloc( (PAR_TASK_CUTOFF + 2) * sizeof(t_hull_task));
+	t_line *local_lines = (t_line *) malloc( (PAR_TASK_CUTOFF + 2) * sizeof(t_line));
+	assert( local_stack != NULL && local_lines != NULL);
+
+	for (;;)
+	{
+		int found = deque_take( dq, &task, 0);
+
+		for (int i = 1; !found && i < num_thread; i++)
+			found = deque_take( &ph->deques[(w->id + i) % num_thread], &task, 1);
+
+		if (found)
+		{
+			pthread_mutex_lock( &ph->lock);
+			ph->queued--;
+			pthread_mutex_unlock( &ph->lock);
+
+			run_par_task( ph, dq, task, local_stack, local_lines);
+			finish_task( ph);
+			continue;
+		}
+
+		// 큐가 모두 비었으면 게시된 탐색/분할을 돕고, 그것도 없으면 깨워질 때까지 기다림
+		pthread_mutex_lock( &ph->lock);
+		if (!help_scan( ph))
+		{
+			if (atomic_load( &ph->pending) == 0)
+			{
+				pthread_mutex_unlock( &ph->lock);
+				break;
+			}
+			if (ph->queued == 0)
+				pthread_cond_wait( &ph->wake, &ph->lock);
+		}
+		pthread_mutex_unlock( &ph->lock);
+	}
+
+	free( local_stack);
+	free( local_lines);
+	return NULL;
+}
+
+// 병렬 quickhull
+// convex_hull_inplace와 같이 points 배열을 제자리에서 분할함 (points의 순서가 바뀜)
+// 선들의 순서는 스레드의 실행 순서에 따라 달라짐
+// [input] points : set of points (x 좌표에 따라 정렬된 상태)
+// [input] num_point : number of points
+// [output] num_line : number of lines
+// return value : pointer of set of line segments that forms the convex hull
+t_line *convex_hull_parallel( t_point *points, int num_point, int *num_line)
+{
+	t_par_hull *ph = (t_par_hull *) malloc( sizeof(t_par_hull));
+	assert( ph != NULL);
+
+	t_worker workers[MAX_THREAD];
+	pthread_t threads[MAX_THREAD];
+	int mid, end;
+
+	ph->points = points;
+	ph->lines = (t_line *) malloc( (num_point + 2) * sizeof(t_line));
+	assert( ph->lines != NULL);
+	ph->scratch = NULL;
+	ph->side = NULL;
+	atomic_init( &ph->num_line, 0);
+	atomic_init( &ph->pending, 1);	// 처음 분할이 끝날 때까지 worker들이 끝나지 않도록
+	ph->queued = 0;
+	ph->scan.func = NULL;
+	pthread_mutex_init( &ph->lock, NULL);
+	pthread_cond_init( &ph->wake, NULL);
+	pthread_cond_init( &ph->scan_done, NULL);
+	pthread_mutex_init( &ph->scan_owner, NULL);
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		ph->deques[i].capacity = 64;
+		ph->deques[i].head = ph->deques[i].tail = 0;
+		ph->deques[i].tasks = (t_hull_task *) malloc( ph->deques[i].capacity * sizeof(t_hull_task));
+		assert( ph->deques[i].tasks != NULL);
+		pthread_mutex_init( &ph->deques[i].lock, NULL);
+	}
+	if (num_point > PAR_SCAN_CUTOFF && num_thread > 1)
+	{
+		ph->scratch = (t_point *) malloc( num_point * sizeof(t_point));
+		ph->side = (unsigned char *) malloc( num_point);
+		assert( ph->scratch != NULL && ph->side != NULL);
+	}
+
+	// 0번 worker는 현재 스레드에서 실행
+	// 다른 worker들은 먼저 시작하여 처음 분할을 함께 처리
+	for (int i = 0; i < num_thread; i++)
+	{
+		workers[i].ph = ph;
+		workers[i].id = i;
+		if (i > 0)
+			pthread_create( &threads[i], NULL, par_worker, &workers[i]);
+	}
+
+	t_point p1 = points[0];
+	t_point pn = points[num_point-1];
+
+	// upper: [0, mid), lower: [mid, end)
+	if (ph->scratch != NULL)
+	{
+		pthread_mutex_lock( &ph->scan_owner);
+		partition_points_par( ph, 0, num_point, p1, pn, pn, p1, &mid, &end);
+		pthread_mutex_unlock( &ph->scan_owner);
+	}
+	else
+		partition_points( points, 0, num_point, p1, pn, pn, p1, &mid, &end);
+
+	atomic_fetch_add( &ph->pending, 2);
+	push_task( ph, &ph->deques[0], (t_hull_task){ pn, p1, mid, end});
+	push_task( ph, &ph->deques[0], (t_hull_task){ p1, pn, 0, mid});
+	finish_task( ph);
+
+	par_worker( &workers[0]);
+	for (int i = 1; i < num_thread; i++)
+		pthread_join( threads[i], NULL);
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		free( ph->deques[i].tasks);
+		pthread_mutex_destroy( &ph->deques[i].lock);
+	}
+	pthread_mutex_destroy( &ph->lock);
+	pthread_cond_destroy( &ph->wake);
+	pthread_cond_destroy( &ph->scan_done);
+	pthread_mutex_destroy( &ph->scan_owner);
+
+	t_line *lines = ph->lines;
+	*num_line = atomic_load( &ph->num_line);
+
+	free( ph->scratch);
+	free( ph->side);
+	free( ph);
+
+	return lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SoA(structure of arrays) quickhull
+// 점들을 x[], y[] 두 배열로 나누어 저장하고, 가장 먼 점 탐색과 분할을 벡터화된 커널로 처리
+// AVX2를 지원하는 CPU에서는 AVX2 커널을, 그렇지 않으면 스칼라 커널을 사용 (실행 시간에 선택)
+// 두 커널은 32비트 정수로 계산하므로 모든 좌표의 절댓값이 SOA_INT32_LIMIT 보다 작을 때만 사용하고
+// (|c - (ax+by)| <= 6 * 2^28 < 2^31), 그 외에는 orient2d로 계산하는 커널을 사용
+#define SOA_INT32_LIMIT	(1 << 14)
+
+// 직선 p1->pn 으로부터 가장 먼 점을 찾는 커널 (x[0] ~ x[n-1], y[0] ~ y[n-1])
+// 같은 거리의 점이 여럿이면 farthest_point와 같이 (x, y) 순서로 가장 앞의 점을 선택
+// return value : 가장 먼 점의 index
+typedef int (*t_farthest_kernel)( const int *x, const int *y, int n, t_point p1, t_point pn);
+
+// 직선 from->to 의 upper(left)에 있는 점들의 index를 차례로 index에 저장하는 커널
+// index에는 n + 8 개 만큼의 공간이 있어야 함
+// return value : 저장된 index의 수
+typedef int (*t_upper_kernel)( const int *x, const int *y, int n, t_point from, t_point to, int *index);
+
+static int farthest_scalar( const int *x, const int *y, int n, t_point p1, t_point pn)
+{
+	int a = pn.y - p1.y;
+	int b = p1.x - pn.x;
+	int c = p1.x * pn.y - p1.y * pn.x;
+	int max = 0;
+	int maxi = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		int dist = c - (a * x[i] + b * y[i]);
+		if (max < dist || (max == dist && dist > 0 && (x[i] < x[maxi] || (x[i] == x[maxi] && y[i] < y[maxi]))))
+		{
+			max = dist;
+			maxi = i;
+		}
+	}
+	return maxi;
+}
+
+static int upper_scalar( const int *x, const int *y, int n, t_point from, t_point to, int *index)
+{
+	int a = to.y - from.y;
+	int b = from.x - to.x;
+	int c = from.x * to.y - from.y * to.x;
+	int count = 0;
+
+	// 분기 없이 index를 저장하고 조건을 만족할 때만 count를 증가
+	for (int i = 0; i < n; i++)
+	{
+		index[count] = i;
+		count += (a * x[i] + b * y[i] < c);
+	}
+	return count;
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define USE_AVX2
+#include <immintrin.h>
+
+// movemask(8비트)에 해당하는 lane들을 앞으로 모으는 permutation 표
+static int compact_table[256][8];
+
+static void init_compact_table( void)
+{
+	for (int mask = 0; mask < 256; mask++)
+	{
+		int k = 0;
+		for (int i = 0; i < 8; i++)
+			if (mask & (1 << i))
+				compact_table[mask][k++] = i;
+		while (k < 8)
+			compact_table[mask][k++] = 0;
+	}
+}
+
+__attribute__((target("avx2")))
+static int farthest_avx2( const int *x, const int *y, int n, t_point p1, t_point pn)
+{
+	int a = pn.y - p1.y;
+	int b = p1.x - pn.x;
+	int c = p1.x * pn.y - p1.y * pn.x;
+	__m256i va = _mm256_set1_epi32( a);
+	__m256i vb = _mm256_set1_epi32( b);
+	__m256i vc = _mm256_set1_epi32( c);
+	__m256i vmax = _mm256_setzero_si256();
+	__m256i vmaxi = _mm256_setzero_si256();
+	__m256i vmaxx = _mm256_setzero_si256();
+	__m256i vmaxy = _mm256_setzero_si256();
+	__m256i vi = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7);
+	__m256i v8 = _mm256_set1_epi32( 8);
+	int i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256i vx = _mm256_loadu_si256( (const __m256i *)(x + i));
+		__m256i vy = _mm256_loadu_si256( (const __m256i *)(y + i));
+		__m256i dist = _mm256_sub_epi32( vc, _mm256_add_epi32( _mm256_mullo_epi32( va, vx), _mm256_mullo_epi32( vb, vy)));
+		// dist > max || (dist == max && (x, y) < (maxx, maxy))
+		__m256i before = _mm256_or_si256( _mm256_cmpgt_epi32( vmaxx, vx),
+			_mm256_and_si256( _mm256_cmpeq_epi32( vmaxx, vx), _mm256_cmpgt_epi32( vmaxy, vy)));
+		__m256i gt = _mm256_or_si256( _mm256_cmpgt_epi32( dist, vmax), _mm256_and_si256( _mm256_cmpeq_epi32( dist, vmax), before));
+		vmax = _mm256_blendv_epi8( vmax, dist, gt);
+		vmaxi = _mm256_blendv_epi8( vmaxi, vi, gt);
+		vmaxx = _mm256_blendv_epi8( vmaxx, vx, gt);
+		vmaxy = _mm256_blendv_epi8( vmaxy, vy, gt);
+		vi = _mm256_add_epi32( vi, v8);
+	}
+
+	int lane_max[8], lane_maxi[8];
+	_mm256_storeu_si256( (__m256i *) lane_max, vmax);
+	_mm256_storeu_si256( (__m256i *) lane_maxi, vmaxi);
+
+	// lane 별 결과와 나머지 점들을 스칼라 커널과 같은 규칙으로 비교
+	int max = 0;
+	int maxi = 0;
+	for (int k = 0; k < 8 + n - i; k++)
+	{
+		int j = (k < 8) ? lane_maxi[k] : i + k - 8;
+		int dist = (k < 8) ? lane_max[k] : c - (a * x[j] + b * y[j]);
+		if (max < dist || (max == dist && dist > 0 && (x[j] < x[maxi] || (x[j] == x[maxi] && y[j] < y[maxi]))))
+		{
+			max = dist;
+			maxi = j;
+		}
+	}
+	return maxi;
+}
+
+__attribute__((target("avx2")))
+static int upper_avx2( const int *x, const int *y, int n, t_point from, t_point to, int *index)
+{
+	int a = to.y - from.y;
+	int b = from.x - to.x;
+	int c = from.x * to.y - from.y * to.x;
+	__m256i va = _mm256_set1_epi32( a);
+	__m256i vb = _mm256_set1_epi32( b);
+	__m256i vc = _mm256_set1_epi32( c);
+	__m256i vi = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7);
+	__m256i v8 = _mm256_set1_epi32( 8);
+	int count = 0;
+	int i;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		__m256i vx = _mm256_loadu_si256( (const __m256i *)(x + i));
+		__m256i vy = _mm256_loadu_si256( (const __m256i *)(y + i));
+		__m256i val = _mm256_add_epi32( _mm256_mullo_epi32( va, vx), _mm256_mullo_epi32( vb, vy));
+		int mask = _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpgt_epi32( vc, val)));
+		__m256i perm = _mm256_loadu_si256( (const __m256i *) compact_table[mask]);
+		_mm256_storeu_si256( (__m256i *)(index + count), _mm256_permutevar8x32_epi32( vi, perm));
+		count += __builtin_popcount( mask);
+		vi = _mm256_add_epi32( vi, v8);
+	}
+	for (; i < n; i++)
+	{
+		index[count] = i;
+		count += (a * x[i] + b * y[i] < c);
+	}
+	return count;
+}
+#endif
+
+static t_farthest_kernel farthest_kernel = farthest_scalar;
+static t_upper_kernel upper_kernel = upper_scalar;
+
+static int farthest_wide( const int *x, const int *y, int n, t_point p1, t_point pn)
+{
+	t_wide max = 0;
+	int maxi = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		t_wide dist = orient2d( p1, pn, (t_point){ x[i], y[i]});
+		if (max < dist || (max == dist && dist > 0 && (x[i] < x[maxi] || (x[i] == x[maxi] && y[i] < y[maxi]))))
+		{
+			max = dist;
+			maxi = i;
+		}
+	}
+	return maxi;
+}
+
+static int upper_wide( const int *x, const int *y, int n, t_point from, t_point to, int *index)
+{
+	int count = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		index[count] = i;
+		count += (orient2d_sign( from, to, (t_point){ x[i], y[i]}) > 0);
+	}
+	return count;
+}
+
+// CPU가 지원하는 명령어에 따라 커널을 선택
+static void select_kernels( void)
+{
+#ifdef USE_AVX2
+	static int initialized = 0;
+
+	if (initialized) return;
+	initialized = 1;
+
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports( "avx2"))
+	{
+		init_compact_table();
+		farthest_kernel = farthest_avx2;
+		upper_kernel = upper_avx2;
+	}
+#endif
+}
+
+// SoA quickhull의 부분 문제
+// buf[k].x[lo] ~ buf[k].x[hi-1] 의 점들은 모두 직선 p1->pn 의 upper(left)에 있음
+typedef struct
+{
+	t_point p1;
+	t_point pn;
+	int lo;
+	int hi;
+	int k;
+} t_soa_task;
+
+typedef struct
+{
+	int *x;
+	int *y;
+} t_soa;
+
+// src의 [lo, lo+n) 에서 직선 from->to 의 upper(left)에 있는 점들을 dst의 at 위치부터 모아서 저장
+// return value : 저장된 점의 수
+static int soa_select( t_upper_kernel upper, t_soa src, t_soa dst, int lo, int n, t_point from, t_point to, int *index, int at)
+{
+	int count = upper( src.x + lo, src.y + lo, n, from, to, index);
+
+	for (int i = 0; i < count; i++)
+	{
+		dst.x[at + i] = src.x[lo + index[i]];
+		dst.y[at + i] = src.y[lo + index[i]];
+	}
+	return count;
+}
+
+// SoA quickhull
+// 두 개의 SoA 버퍼를 번갈아 사용하며, 각 부분 문제는 자신의 구간 안에서만 다른 버퍼로 점들을 모아서 자식 부분 문제를 만든다.
+// (점들의 순서를 바꾸지 않음)
+// [input] points : set of points (x 좌표에 따라 정렬된 상태)
+// [input] num_point : number of points
+// [output] num_line : number of lines
+// return value : pointer of set of line segments that forms the convex hull
+t_line *convex_hull_soa( t_point *points, int num_point, int *num_line)
+{
+	t_soa buf[2];
+	int *index = (int *) malloc( (num_point + 8) * sizeof(int));
+	t_soa_task *stack = (t_soa_task *) malloc( (num_point + 2) * sizeof(t_soa_task));
+	t_line *lines = (t_line *) malloc( (num_point + 2) * sizeof(t_line));
+	int top = 0;
+
+	select_kernels();
+
+	for (int k = 0; k < 2; k++)
+	{
+		buf[k].x = (int *) malloc( num_point * sizeof(int));
+		buf[k].y = (int *) malloc( num_point * sizeof(int));
+		assert( buf[k].x != NULL && buf[k].y != NULL);
+	}
+	assert( index != NULL && stack != NULL && lines != NULL);
+
+	int small = 1; // 32비트 정수 커널을 사용할 수 있는지
+
+	for (int i = 0; i < num_point; i++)
+	{
+		buf[0].x[i] = points[i].x;
+		buf[0].y[i] = points[i].y;
+		small &= (points[i].x > -SOA_INT32_LIMIT && points[i].x < SOA_INT32_LIMIT && points[i].y > -SOA_INT32_LIMIT && points[i].y < SOA_INT32_LIMIT);
+	}
+
+	t_farthest_kernel farthest = small ? farthest_kernel : farthest_wide;
+	t_upper_kernel upper = small ? upper_kernel : upper_wide;
+
+	t_point p1 = points[0];
+	t_point pn = points[num_point-1];
+
+	int n1 = soa_select( upper, buf[0], buf[1], 0, num_point, p1, pn, index, 0);
+	int n2 = soa_select( upper, buf[0], buf[1], 0, num_point, pn, p1, index, n1);
+
+	// upper hull을 먼저 처리하도록 lower hull을 먼저 쌓는다.
+	stack[top++] = (t_soa_task){ pn, p1, n1, n1 + n2, 1};
+	stack[top++] = (t_soa_task){ p1, pn, 0, n1, 1};
+
+	*num_line = 0;
+	while (top > 0)
+	{
+		t_soa_task task = stack[--top];
+		int n = task.hi - task.lo;
+
+		if (n == 0)
+		{
+			lines[*num_line].from = task.p1;
+			lines[*num_line].to = task.pn;
+			(*num_line)++;
+			continue;
+		}
+
+		t_soa src = buf[task.k];
+		t_soa dst = buf[1 - task.k];
+		int maxi = task.lo + farthest( src.x + task.lo, src.y + task.lo, n, task.p1, task.pn);
+		t_point maxp = { src.x[maxi], src.y[maxi]};
+
+		n1 = soa_select( upper, src, dst, task.lo, n, task.p1, maxp, index, task.lo);
+		n2 = soa_select( upper, src, dst, task.lo, n, maxp, task.pn, index, task.lo + n1);
+
+		stack[top++] = (t_soa_task){ maxp, task.pn, task.lo + n1, task.lo + n1 + n2, 1 - task.k};
+		stack[top++] = (t_soa_task){ task.p1, maxp, task.lo, task.lo + n1, 1 - task.k};
+	}
+
+	for (int k = 0; k < 2; k++)
+	{
+		free( buf[k].x);
+		free( buf[k].y);
+	}
+	free( index);
+	free( stack);
+
+	return lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+// Andrew's monotone chain
+
+// monotone chain (hull_core_chain, common/hull_core.hpp)
+// 메모리를 할당하지 않으며 points의 순서를 바꾸지 않음
+// hull의 뒤쪽 절반을 hull_core_chain의 위치 목록으로 사용하고, 앞에서부터 꼭짓점으로 바꿔 씀
+// (꼭짓점 i가 덮는 int 2i, 2i+1 은 아직 읽지 않은 위치 pos[i+1] (int num_point+2+i+1) 보다 앞)
+// [input] points : set of points (x, y 순서로 정렬된 상태)
+// [input] num_point : number of points
+// [output] hull : convex hull의 꼭짓점 (가장 왼쪽(아래)의 점부터 반시계 방향, 한 직선 위의 점들은 양 끝 점만)
+//                 num_point + 2 개의 공간이 있어야 함
+// return value : 꼭짓점의 수
+int monotone_chain( t_point *points, int num_point, t_point *hull)
+{
+	int *pos = (int *) hull + (num_point + 2);
+	int k = hull_core_chain( points, sizeof(t_point), num_point, pos);
+
+	// 같은 메모리를 int와 t_point로 쓰므로 memcpy로 복사
+	for (int i = 0; i < k; i++)
+		memcpy( hull + i, points + pos[i], sizeof(t_point));
+	return k;
+}
+
+// 반시계 방향의 꼭짓점 목록(hull, 꼭짓점 수 k)을 선들로 바꾸는 함수
+// 꼭짓점이 하나인 경우 quickhull과 같이 upper, lower 각각 한 선
+// lines는 hull 뒤쪽과 겹쳐도 됨 (hull이 lines + k 보다 뒤에 있는 경우)
+// return value : 선의 수
+static int ring_to_lines( t_point *hull, int k, t_line *lines)
+{
+	t_point first = hull[0];
+
+	if (k == 1)
+	{
+		lines[0] = lines[1] = (t_line){ first, first};
+		return 2;
+	}
+	for (int i = 0; i < k - 1; i++)
+		lines[i] = (t_line){ hull[i], hull[i+1]};
+	lines[k-1] = (t_line){ hull[k-1], first};
+	return k;
+}
+
+// monotone chain
+// 출력 버퍼의 뒤쪽 절반을 꼭짓점 목록으로 사용하므로 출력 버퍼 외에는 메모리를 할당하지 않음
+// [input] points : set of points (x, y 순서로 정렬된 상태)
+// [input] num_point : number of points
+// [output] num_line : number of lines
+// return value : pointer of set of line segments that forms the convex hull
+t_line *convex_hull_monotone( t_point *points, int num_point, int *num_line)
+{
+	t_line *lines = (t_line *) malloc( (num_point + 2) * sizeof(t_line));
+	assert( lines != NULL);
+
+	t_point *hull = (t_point *) lines + (num_point + 2);
+	int k = monotone_chain( points, num_point, hull);
+
+	*num_line = ring_to_lines( hull, k, lines);
+
+	return lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// index 기반의 convex hull
+// 선마다 두 끝 점을 복사하는 t_line 대신 points의 index를 반시계 방향으로 저장
+// (꼭짓점마다 int 하나이므로 메모리가 t_line의 1/4, 선들을 이어 붙이지 않고 바로 다각형을 따라갈 수 있음)
+
+// index와 함께 정렬하기 위한 점 (p가 처음에 있으므로 cmp_x로 비교할 수 있음)
+typedef struct
+{
+	t_point p;
+	int index;
+} t_indexed_point;
+
+// monotone chain으로 convex hull의 꼭짓점들을 points의 index로 구하는 함수
+// points의 순서는 바꾸지 않으며 정렬되어 있지 않아도 됨 (정렬되어 있으면 다시 정렬하지 않음)
+// 꼭짓점은 num_point + 2 개를 넘지 않으므로 그만큼 미리 할당하고 마지막에 줄임
+// [input] points : set of points
+// [input] num_point : number of points (1 이상)
+// [output] num_hull : 꼭짓점의 수
+// return value : 꼭짓점들의 index (가장 왼쪽(아래)의 점부터 반시계 방향, 한 직선 위의 점들은 양 끝 점만)
+//                같은 점이 여럿이면 그 중 하나의 index
+int *convex_hull_ccw( const t_point *points, int num_point, int *num_hull)
+{
+	t_indexed_point *sorted = (t_indexed_point *) malloc( num_point * sizeof(t_indexed_point));
+	int *hull = (int *) malloc( (num_point + 2) * sizeof(int));
+	int is_sorted = 1;
+	assert( sorted != NULL && hull != NULL);
+
+	for (int i = 0; i < num_point; i++)
+	{
+		sorted[i].p = points[i];
+		sorted[i].index = i;
+		if (i > 0 && cmp_x( &points[i-1], &points[i]) > 0)
+			is_sorted = 0;
+	}
+	if (!is_sorted)
+		qsort( sorted, num_point, sizeof(t_indexed_point), cmp_x);
+
+	// monotone_chain과 같은 hull_core_chain으로 꼭짓점들의 sorted에서의 위치를 구함
+	int k = hull_core_chain( sorted, sizeof(t_indexed_point), num_point, hull);
+
+	// 정렬된 위치를 points의 index로
+	for (int i = 0; i < k; i++)
+		hull[i] = sorted[hull[i]].index;
+	free( sorted);
+
+	*num_hull = k;
+	return (int *) realloc( hull, k * sizeof(int));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Chan's algorithm (O(n log h))
+// 점들을 m 개씩 묶어 각 묶음의 convex hull(mini hull)을 구하고, 가장 왼쪽 점에서부터 gift wrapping을 한다.
+// gift wrapping의 각 단계에서는 mini hull마다 이분 탐색으로 접점(tangent)을 구함
+// m 단계 안에 끝나지 않으면 m을 제곱하여 다시 시작 (m = 4, 16, 256, ...)
+
+// 반시계 방향 mini hull H(꼭짓점 수 k)에서 점 p에 대한 접점을 이분 탐색으로 찾는 함수
+// 접점은 H의 모든 꼭짓점이 직선 p->접점 의 왼쪽 또는 직선 위에 있는 꼭짓점 (직선 위에 둘이면 먼 쪽)
+// p는 H의 바깥에 있어야 함
+// return value : 접점의 index
+static int tangent_index( t_point *H, int k, t_point p)
+{
+	// a가 b보다 p에서 보아 시계 방향에 있으면 양수
+#define TANGENT_CMP(a, b) (orient2d_sign( p, H[(a) % k], H[(b) % k]))
+#define IS_TANGENT(i) (TANGENT_CMP( (i) + 1, (i)) <= 0 && TANGENT_CMP( (i), (i) - 1 + k) > 0)
+	int lo = 0, hi = k;
+	int t = -1;
+
+	if (k < 3 || IS_TANGENT( 0))
+		t = 0;
+	while (t < 0 && lo + 1 < hi)
+	{
+		int m = (lo + hi) / 2;
+		if (IS_TANGENT( m))
+		{
+			t = m;
+			break;
+		}
+		int ls = TANGENT_CMP( lo + 1, lo);
+		int ms = TANGENT_CMP( m + 1, m);
+		int lm = TANGENT_CMP( lo, m);
+		if (ls > ms || (ls == ms && ls == lm))
+			hi = m;
+		else
+			lo = m;
+	}
+	if (t < 0)
+		t = lo;
+#undef IS_TANGENT
+#undef TANGENT_CMP
+
+	// 두 점만 있거나 다음 꼭짓점이 같은 직선 위에 있는 경우
+	int next = (t + 1) % k;
+	int o = orient2d_sign( p, H[t], H[next]);
+	if (o < 0 || (o == 0 && dist2( p, H[next]) > dist2( p, H[t])))
+		t = next;
+	return t;
+}
+
+// 반시계 방향 mini hull H(꼭짓점 수 k, 가장 오른쪽 꼭짓점의 index r)에서 점 p를 이분 탐색으로 찾는 함수
+// H[0] ~ H[r] 은 (x, y) 순서로 증가, H[r] ~ H[k-1] 은 감소
+// return value : p의 index, 없는 경우 -1
+static int find_vertex( t_point *H, int k, int r, t_point p)
+{
+	int lo = 0, hi = r;
+	while (lo <= hi)
+	{
+		int m = (lo + hi) / 2;
+		if (H[m].x == p.x && H[m].y == p.y) return m;
+		if (is_before( H[m], p)) lo = m + 1;
+		else hi = m - 1;
+	}
+	lo = r; hi = k - 1;
+	while (lo <= hi)
+	{
+		int m = (lo + hi) / 2;
+		if (H[m].x == p.x && H[m].y == p.y) return m;
+		if (is_before( p, H[m])) lo = m + 1;
+		else hi = m - 1;
+	}
+	return -1;
+}
+
+// Chan's algorithm
+// 각 묶음을 qsort(cmp_x)로 정렬하므로 points의 순서가 바뀜
+// 선들은 가장 왼쪽 점에서 시작하여 반시계 방향 순서로 저장됨
+// [input] points : set of points
+// [input] num_point : number of points
+// [output] num_line : number of lines
+// return value : pointer of set of line segments that forms the convex hull
+t_line *convex_hull_chan( t_point *points, int num_point, int *num_line)
+{
+	t_line *lines = (t_line *) malloc( (num_point + 2) * sizeof(t_line));
+	// 묶음 g의 mini hull은 hulls[start[g]] 부터 size[g] 개 (각 묶음마다 점의 수 + 2 개의 공간)
+	t_point *hulls = (t_point *) malloc( 3 * num_point * sizeof(t_point));
+	int *start = (int *) malloc( num_point * sizeof(int));
+	int *size = (int *) malloc( num_point * sizeof(int));
+	int *right = (int *) malloc( num_point * sizeof(int));
+	assert( lines != NULL && hulls != NULL && start != NULL && size != NULL && right != NULL);
+
+	for (int t = 1; ; t++)
+	{
+		// m = 2^(2^t)
+		int m = (t >= 5 || (1 << (1 << t)) >= num_point) ? num_point : (1 << (1 << t));
+		int num_group = (num_point + m - 1) / m;
+
+		for (int g = 0; g < num_group; g++)
+		{
+			int lo = g * m;
+			int n = (lo + m <= num_point) ? m : num_point - lo;
+
+			qsort( points + lo, n, sizeof(t_point), cmp_x);
+			start[g] = lo + 2 * g;
+			size[g] = monotone_chain( points + lo, n, hulls + start[g]);
+
+			right[g] = 0;
+			for (int i = 1; i < size[g]; i++)
+				if (is_before( hulls[start[g] + right[g]], hulls[start[g] + i]))
+					right[g] = i;
+		}
+
+		// 가장 왼쪽(아래)의 점에서 시작
+		int pg = 0;
+		for (int g = 1; g < num_group; g++)
+			if (is_before( hulls[start[g]], hulls[start[pg]]))
+				pg = g;
+
+		t_point first = hulls[start[pg]];
+		t_point p = first;
+		int pi = 0; // p의 묶음 pg 에서의 index
+		int done = 0;
+
+		*num_line = 0;
+		for (int step = 0; step < m && !done; step++)
+		{
+			int bg = -1, bi = -1;
+			t_point best = p;
+
+			for (int g = 0; g < num_group; g++)
+			{
+				t_point *H = hulls + start[g];
+				int i;
+
+				if (g == pg)
+					i = (pi + 1) % size[g];
+				else if ((i = find_vertex( H, size[g], right[g], p)) >= 0)
+					i = (i + 1) % size[g];
+				else
+					i = tangent_index( H, size[g], p);
+
+				t_point q = H[i];
+				if (q.x == p.x && q.y == p.y)
+					continue;
+
+				int o = (bg < 0) ? -1 : orient2d_sign( p, best, q);
+				if (o < 0 || (o == 0 && dist2( p, q) > dist2( p, best)))
+				{
+					best = q;
+					bg = g;
+					bi = i;
+				}
+			}
+
+			// 모든 점이 같은 경우 (quickhull과 같이 upper, lower 각각 한 선)
+			if (bg < 0)
+			{
+				lines[(*num_line)++] = (t_line){ p, p};
+				lines[(*num_line)++] = (t_line){ p, p};
+				done = 1;
+				break;
+			}
+
+			lines[(*num_line)++] = (t_line){ p, best};
+			p = best;
+			pg = bg;
+			pi = bi;
+			if (p.x == first.x && p.y == first.y)
+				done = 1;
+		}
+
+		if (done)
+			break;
+	}
+
+	free( hulls);
+	free( start);
+	free( size);
+	free( right);
+
+	return lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// incremental convex hull
+// 점을 하나씩 추가하면서 convex hull을 유지한다.
+// lower hull과 upper hull을 각각 x, y 순서의 treap(균형 이진 탐색 트리)에 저장
+// upper hull은 순서를 뒤집은 treap에 저장하여 (원점 대칭한 점들의 lower hull과 같음) lower hull과 같은 코드를 사용
+// 점을 추가할 때는 양 옆의 꼭짓점을 찾아 (O(log h)) chain의 안쪽이면 바로 버리고,
+// 아니면 점을 넣고 볼록하지 않게 된 꼭짓점들을 양쪽으로 지운다. (지운 꼭짓점은 다시 들어오지 않으므로 amortized O(log h))
+
+typedef struct
+{
+	t_point p;
+	unsigned int priority;
+	int child[2];			// 0 : 앞(왼쪽), 1 : 뒤(오른쪽), 없으면 -1
+} t_treap_node;
+
+// 되돌리기 기록의 종류
+#define UNDO_MARK		0	// chain_insert 한 번의 끝
+#define UNDO_INSERTED	1	// p를 넣음
+#define UNDO_ERASED		2	// p를 지움
+
+typedef struct
+{
+	t_point p;
+	int op;					// UNDO_*
+} t_undo;
+
+typedef struct
+{
+	t_treap_node *node;		// node pool
+	int capacity;
+	int num_node;			// 사용한 node의 수 (free_list 포함)
+	int free_list;			// 지운 node들 (child[0]으로 연결)
+	int root;
+	int size;				// 꼭짓점의 수
+	int reverse;			// 1 : upper hull (x, y의 역순)
+	unsigned int seed;		// priority를 만드는 xorshift의 상태
+	t_undo *log;			// 되돌리기 위한 기록 (undo가 0이면 기록하지 않음)
+	int num_log;
+	int log_capacity;
+	int undo;
+} t_chain;
+
+typedef struct
+{
+	t_chain lower;
+	t_chain upper;
+} t_inc_hull;
+
+// chain의 순서로 a가 b보다 앞이면 1
+static int chain_before( t_chain *c, t_point a, t_point b)
+{
+	return c->reverse ? is_before( b, a) : is_before( a, b);
+}
+
+static void chain_init( t_chain *c, int reverse)
+{
+	c->node = NULL;
+	c->capacity = c->num_node = c->size = 0;
+	c->free_list = c->root = -1;
+	c->reverse = reverse;
+	c->seed = reverse ? 0x9e3779b9 : 2463534242u;
+	c->log = NULL;
+	c->num_log = c->log_capacity = c->undo = 0;
+}
+
+static void chain_log( t_chain *c, t_point p, int op)
+{
+	if (!c->undo)
+		return;
+	if (c->num_log == c->log_capacity)
+	{
+		c->log_capacity = (c->log_capacity == 0) ? 16 : c->log_capacity * 2;
+		c->log = (t_undo *) realloc( c->log, c->log_capacity * sizeof(t_undo));
+		assert( c->log != NULL);
+	}
+	c->log[c->num_log++] = (t_undo){ p, op};
+}
+
+// 새 node를 만드는 함수 (node pool이 realloc 될 수 있으므로 node의 포인터를 가지고 있으면 안 됨)
+// return value : node의 index
+static int chain_alloc( t_chain *c, t_point p)
+{
+	int n = c->free_list;
+
+	if (n != -1)
+		c->free_list = c->node[n].child[0];
+	else
+	{
+		if (c->num_node == c->capacity)
+		{
+			c->capacity = (c->capacity == 0) ? 16 : c->capacity * 2;
+			c->node = (t_treap_node *) realloc( c->node, c->capacity * sizeof(t_treap_node));
+			assert( c->node != NULL);
+		}
+		n = c->num_node++;
+	}
+
+	c->seed ^= c->seed << 13;
+	c->seed ^= c->seed >> 17;
+	c->seed ^= c->seed << 5;
+
+	c->node[n] = (t_treap_node){ p, c->seed, { -1, -1}};
+	c->size++;
+	return n;
+}
+
+// root를 뿌리로 하는 treap에 node n을 넣음
+// return value : 새 뿌리
+static int treap_insert( t_chain *c, int root, int n)
+{
+	t_treap_node *node = c->node;
+
+	if (root == -1)
+		return n;
+
+	int dir = chain_before( c, node[root].p, node[n].p);
+	int child = treap_insert( c, node[root].child[dir], n);
+	node[root].child[dir] = child;
+
+	// priority가 큰 node가 위로 오도록 회전
+	if (node[child].priority > node[root].priority)
+	{
+		node[root].child[dir] = node[child].child[!dir];
+		node[child].child[!dir] = root;
+		return child;
+	}
+	return root;
+}
+
+// a의 모든 점이 b의 모든 점보다 앞인 두 treap을 합침
+// return value : 새 뿌리
+static int treap_merge( t_chain *c, int a, int b)
+{
+	t_treap_node *node = c->node;
+
+	if (a == -1) return b;
+	if (b == -1) return a;
+
+	if (node[a].priority > node[b].priority)
+	{
+		node[a].child[1] = treap_merge( c, node[a].child[1], b);
+		return a;
+	}
+	node[b].child[0] = treap_merge( c, a, node[b].child[0]);
+	return b;
+}
+
+// root를 뿌리로 하는 treap에서 점 p를 지움
+// return value : 새 뿌리
+static int treap_erase( t_chain *c, int root, t_point p)
+{
+	t_treap_node *node = c->node;
+
+	if (root == -1)
+		return -1;
+
+	if (node[root].p.x == p.x && node[root].p.y == p.y)
+	{
+		int merged = treap_merge( c, node[root].child[0], node[root].child[1]);
+
+		node[root].child[0] = c->free_list;
+		c->free_list = root;
+		c->size--;
+		return merged;
+	}
+
+	int dir = chain_before( c, node[root].p, p);
+	node[root].child[dir] = treap_erase( c, node[root].child[dir], p);
+	return root;
+}
+
+// p 바로 앞(dir 0) 또는 바로 뒤(dir 1)의 꼭짓점을 찾는 함수 (p와 같은 점은 제외)
+// [output] q : 찾은 꼭짓점
+// return value : 찾으면 1, 없으면 0
+static int chain_neighbor( t_chain *c, t_point p, int dir, t_point *q)
+{
+	int found = 0;
+
+	for (int i = c->root; i != -1; )
+	{
+		t_point v = c->node[i].p;
+
+		if (dir ? chain_before( c, p, v) : chain_before( c, v, p))
+		{
+			// v는 후보, p에 더 가까운 쪽으로
+			*q = v;
+			found = 1;
+			i = c->node[i].child[!dir];
+		}
+		else
+			i = c->node[i].child[dir];
+	}
+	return found;
+}
+
+// return value : p가 chain의 꼭짓점이면 1
+static int chain_find( t_chain *c, t_point p)
+{
+	for (int i = c->root; i != -1; )
+	{
+		t_point v = c->node[i].p;
+
+		if (v.x == p.x && v.y == p.y)
+			return 1;
+		i = c->node[i].child[chain_before( c, v, p)];
+	}
+	return 0;
+}
+
+// chain에 p를 추가
+// return value : p가 chain의 꼭짓점이 되면 1, chain의 안쪽(또는 위)이라 버렸으면 0
+static int chain_insert( t_chain *c, t_point p)
+{
+	t_point a, b, q = { 0, 0};	// q는 chain_neighbor가 찾았을 때만 사용 (-Wmaybe-uninitialized)
+
+	// 넣지 않는 경우에도 기록을 남겨 chain_undo 한 번이 chain_insert 한 번을 되돌리도록 함
+	if (chain_find( c, p))
+	{
+		chain_log( c, p, UNDO_MARK);
+		return 0;
+	}
+
+	int has_a = chain_neighbor( c, p, 0, &a);
+	int has_b = chain_neighbor( c, p, 1, &b);
+
+	// a -> b 의 왼쪽(또는 위)이면 chain의 안쪽
+	if (has_a && has_b && orient2d_sign( a, b, p) >= 0)
+	{
+		chain_log( c, p, UNDO_MARK);
+		return 0;
+	}
+
+	// p를 넣으면 볼록하지 않게 되는 꼭짓점들을 지움
+	while (has_a && chain_neighbor( c, a, 0, &q) && orient2d_sign( q, a, p) <= 0)
+	{
+		c->root = treap_erase( c, c->root, a);
+		chain_log( c, a, UNDO_ERASED);
+		a = q;
+	}
+	while (has_b && chain_neighbor( c, b, 1, &q) && orient2d_sign( p, b, q) <= 0)
+	{
+		c->root = treap_erase( c, c->root, b);
+		chain_log( c, b, UNDO_ERASED);
+		b = q;
+	}
+
+	int n = chain_alloc( c, p);
+	c->root = treap_insert( c, c->root, n);
+	chain_log( c, p, UNDO_INSERTED);
+	chain_log( c, p, UNDO_MARK);
+	return 1;
+}
+
+// 마지막 chain_insert를 되돌림 (넣은 점을 지우고 지웠던 꼭짓점들을 다시 넣음)
+// 시간은 되돌리는 chain_insert가 쓴 시간과 같은 O((지운 꼭짓점 수 + 1) log h)
+static void chain_undo( t_chain *c)
+{
+	assert( c->num_log > 0 && c->log[c->num_log-1].op == UNDO_MARK);
+	c->num_log--;
+
+	while (c->num_log > 0 && c->log[c->num_log-1].op != UNDO_MARK)
+	{
+		t_undo *u = &c->log[--c->num_log];
+
+		if (u->op == UNDO_INSERTED)
+			c->root = treap_erase( c, c->root, u->p);
+		else
+			c->root = treap_insert( c, c->root, chain_alloc( c, u->p));
+	}
+}
+
+// chain의 꼭짓점들을 순서대로 out에 씀
+// return value : 다음에 쓸 위치
+static int chain_walk( t_chain *c, int root, t_point *out, int k)
+{
+	if (root == -1)
+		return k;
+
+	k = chain_walk( c, c->node[root].child[0], out, k);
+	out[k++] = c->node[root].p;
+	return chain_walk( c, c->node[root].child[1], out, k);
+}
+
+void inc_hull_init( t_inc_hull *h)
+{
+	chain_init( &h->lower, 0);
+	chain_init( &h->upper, 1);
+}
+
+void inc_hull_free( t_inc_hull *h)
+{
+	free( h->lower.node);
+	free( h->upper.node);
+	free( h->lower.log);
+	free( h->upper.log);
+}
+
+// 이후의 inc_hull_insert를 inc_hull_undo로 되돌릴 수 있도록 기록함 (점 하나당 O(1) 메모리)
+void inc_hull_set_undo( t_inc_hull *h)
+{
+	h->lower.undo = h->upper.undo = 1;
+}
+
+// convex hull에 점 p를 추가
+// return value : p가 convex hull의 꼭짓점이 되면 1, convex hull의 안쪽(또는 변 위)이면 0
+int inc_hull_insert( t_inc_hull *h, t_point p)
+{
+	int lower = chain_insert( &h->lower, p);
+	int upper = chain_insert( &h->upper, p);
+
+	return lower || upper;
+}
+
+// 마지막 inc_hull_insert를 되돌림 (inc_hull_set_undo 이후에 넣은 점만, 넣은 역순으로)
+void inc_hull_undo( t_inc_hull *h)
+{
+	chain_undo( &h->lower);
+	chain_undo( &h->upper);
+}
+
+// return value : 현재 convex hull의 꼭짓점 수 (점이 없으면 0)
+int inc_hull_size( t_inc_hull *h)
+{
+	if (h->lower.size < 2)
+		return h->lower.size;
+	return h->lower.size + h->upper.size - 2;
+}
+
+// 현재 convex hull의 꼭짓점들 (monotone_chain과 같이 가장 왼쪽(아래)의 점부터 반시계 방향)
+// [output] ring : inc_hull_size() + 1 개의 공간이 있어야 함
+// return value : 꼭짓점의 수
+int inc_hull_ring( t_inc_hull *h, t_point *ring)
+{
+	int k = chain_walk( &h->lower, h->lower.root, ring, 0);
+
+	if (k < 2)
+		return k;
+
+	// upper hull은 가장 오른쪽 점부터 가장 왼쪽 점까지, 양 끝 점은 lower hull과 같으므로
+	// 가장 오른쪽 점 위에 겹쳐 쓰고 가장 왼쪽 점은 세지 않음
+	int upper = chain_walk( &h->upper, h->upper.root, ring + k - 1, 0);
+	return k + upper - 2;
+}
+
+// 현재 convex hull을 선들로 (batch 알고리즘들과 같은 형식)
+// [output] num_line : number of lines
+// return value : pointer of set of line segments that forms the convex hull, 점이 없으면 NULL
+t_line *inc_hull_lines( t_inc_hull *h, int *num_line)
+{
+	int k = inc_hull_size( h);
+
+	*num_line = 0;
+	if (k == 0)
+		return NULL;
+
+	// ring_to_lines는 꼭짓점이 하나여도 선 두 개를 씀
+	t_line *lines = (t_line *) malloc( (k + 1) * sizeof(t_line));
+	t_point *ring = (t_point *) malloc( (k + 1) * sizeof(t_point));
+	assert( lines != NULL && ring != NULL);
+
+	k = inc_hull_ring( h, ring);
+	*num_line = ring_to_lines( ring, k, lines);
+
+	free( ring);
+	return lines;
+}
+
+// incremental convex hull에 점들을 주어진 순서대로 추가
+// [input] points : set of points
+// [input] num_point : number of points
+// [output] num_line : number of lines
+// return value : pointer of set of line segments that forms the convex hull
+t_line *convex_hull_incremental( t_point *points, int num_point, int *num_line)
+{
+	t_inc_hull h;
+
+	inc_hull_init( &h);
+	for (int i = 0; i < num_point; i++)
+		inc_hull_insert( &h, points[i]);
+
+	t_line *lines = inc_hull_lines( &h, num_line);
+	inc_hull_free( &h);
+
+	return lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// sliding window convex hull
+// 점들이 차례로 들어올 때 마지막 W 개 점의 convex hull (push_back, pop_front)
+// 두 스택으로 만든 큐 : 새 점은 back (incremental convex hull)에 넣고, 가장 오래된 점은 front에서 뺀다.
+// front가 비면 back의 점들을 새 것부터 되돌리기 기록과 함께 front에 넣고 back을 비우므로
+// 가장 오래된 점은 front에 마지막으로 넣은 점이 되어 pop_front는 inc_hull_undo 한 번이다.
+// 각 점은 back과 front에 한 번씩 들어가고 한 번 되돌려지므로 push_back, pop_front는 amortized O(log W)
+// 창의 convex hull은 두 convex hull의 꼭짓점들을 합병하여 monotone chain으로 O(h)
+
+typedef struct
+{
+	t_point *queue;		// 창 안의 점들 (원형 버퍼, 오래된 것부터)
+	int capacity;
+	int head;
+	int size;
+	int num_front;		// front에 있는 점의 수 (queue의 앞쪽 num_front 개)
+	t_inc_hull front;	// 되돌리기 기록이 있는 convex hull
+	t_inc_hull back;
+} t_window_hull;
+
+void window_init( t_window_hull *w)
+{
+	w->queue = NULL;
+	w->capacity = w->head = w->size = w->num_front = 0;
+	inc_hull_init( &w->front);
+	inc_hull_init( &w->back);
+}
+
+void window_free( t_window_hull *w)
+{
+	free( w->queue);
+	inc_hull_free( &w->front);
+	inc_hull_free( &w->back);
+}
+
+// 창의 뒤에 점 p를 넣음
+void window_push( t_window_hull *w, t_point p)
+{
+	if (w->size == w->capacity)
+	{
+		int capacity = (w->capacity == 0) ? 16 : w->capacity * 2;
+		t_point *queue = (t_point *) malloc( capacity * sizeof(t_point));
+		assert( queue != NULL);
+
+		for (int i = 0; i < w->size; i++)
+			queue[i] = w->queue[(w->head + i) % w->capacity];
+		free( w->queue);
+		w->queue = queue;
+		w->capacity = capacity;
+		w->head = 0;
+	}
+	w->queue[(w->head + w->size) % w->capacity] = p;
+	w->size++;
+	inc_hull_insert( &w->back, p);
+}
+
+// 창의 가장 오래된 점을 뺌 (창이 비어 있으면 안 됨)
+void window_pop( t_window_hull *w)
+{
+	assert( w->size > 0);
+
+	if (w->num_front == 0)
+	{
+		// 모든 점이 back에 있음 : 새 것부터 front에 넣음
+		inc_hull_free( &w->front);
+		inc_hull_init( &w->front);
+		inc_hull_set_undo( &w->front);
+		for (int i = w->size - 1; i >= 0; i--)
+			inc_hull_insert( &w->front, w->queue[(w->head + i) % w->capacity]);
+		w->num_front = w->size;
+
+		inc_hull_free( &w->back);
+		inc_hull_init( &w->back);
+	}
+
+	inc_hull_undo( &w->front);
+	w->num_front--;
+	w->head = (w->head + 1) % w->capacity;
+	w->size--;
+}
+
+// x, y 순서로 정렬된 a와 b (b_reverse가 1이면 역순)를 합병
+// return value : out에 쓴 점의 수 (na + nb)
+static int merge_sorted( const t_point *a, int na, const t_point *b, int nb, int b_reverse, t_point *out)
+{
+	int i = 0, j = 0, k = 0;
+
+	while (i < na || j < nb)
+	{
+		t_point q = (j < nb) ? b[b_reverse ? nb - 1 - j : j] : a[0];
+
+		if (j == nb || (i < na && is_before( a[i], q)))
+			out[k++] = a[i++];
+		else
+		{
+			out[k++] = q;
+			j++;
+		}
+	}
+	return k;
+}
+
+// incremental convex hull의 꼭짓점들을 x, y 순서로 (lower, upper chain의 양 끝 점은 두 번)
+// [output] out : h->lower.size + h->upper.size 개, tmp : 같은 크기의 작업 공간
+// return value : out에 쓴 점의 수
+static int inc_hull_sorted( t_inc_hull *h, t_point *out, t_point *tmp)
+{
+	int lower = chain_walk( &h->lower, h->lower.root, tmp, 0);
+	int upper = chain_walk( &h->upper, h->upper.root, tmp + lower, 0);
+
+	return merge_sorted( tmp, lower, tmp + lower, upper, 1, out);
+}
+
+// 현재 창의 convex hull
+// [output] num_hull : 꼭짓점의 수
+// return value : 꼭짓점들 (monotone_chain과 같이 가장 왼쪽(아래)의 점부터 반시계 방향), 창이 비어 있으면 NULL
+t_point *window_hull( t_window_hull *w, int *num_hull)
+{
+	*num_hull = 0;
+	if (w->size == 0)
+		return NULL;
+
+	int nf = w->front.lower.size + w->front.upper.size;
+	int nb = w->back.lower.size + w->back.upper.size;
+
+	// sorted : 합병한 꼭짓점, part : front, back 각각의 정렬된 꼭짓점, tmp : inc_hull_sorted의 작업 공간
+	t_point *sorted = (t_point *) malloc( 3 * (nf + nb) * sizeof(t_point));
+	assert( sorted != NULL);
+	t_point *part = sorted + nf + nb;
+	t_point *tmp = part + nf + nb;
+
+	inc_hull_sorted( &w->front, part, tmp);
+	inc_hull_sorted( &w->back, part + nf, tmp);
+	int m = merge_sorted( part, nf, part + nf, nb, 0, sorted);
+
+	t_point *hull = (t_point *) malloc( (m + 2) * sizeof(t_point));
+	assert( hull != NULL);
+	*num_hull = monotone_chain( sorted, m, hull);
+
+	free( sorted);
+	return hull;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// ε-근사 convex hull (Bentley-Faust-Preparata)
+// 점들을 x 좌표로 num_strip 개의 세로 띠(strip)로 나누어 띠마다 y가 가장 작은 점과 가장 큰 점만 남기고
+// (x가 가장 작은/큰 점들 중에서는 y가 가장 작은 점과 가장 큰 점도 남김) 2 * num_strip + 4 개 이하의 후보로 convex hull을 구한다.
+// 후보는 모두 입력 점이므로 근사 convex hull은 정확한 convex hull의 안쪽에 있고,
+// 근사 convex hull 밖의 점은 근사 convex hull에서 띠의 폭 (xmax - xmin) / num_strip 이내에 있다.
+// 시간 O(n + k log k), 메모리 O(k) (k = num_strip)
+#define NUM_STRIP	1000
+
+static int num_strip = NUM_STRIP; // 띠의 수 (-k)
+static double approx_error = 0; // 마지막으로 구한 근사 convex hull의 오차 한계 (띠의 폭)
+
+// [input] points : set of points (정렬되어 있지 않아도 됨)
+// [input] num_point : number of points
+// [output] num_line : number of lines
+// return value : pointer of set of line segments that forms the approximate convex hull
+t_line *convex_hull_approx( t_point *points, int num_point, int *num_line)
+{
+	int xmin = points[0].x, xmax = points[0].x;
+
+	for (int i = 1; i < num_point; i++)
+	{
+		if (points[i].x < xmin) xmin = points[i].x;
+		if (points[i].x > xmax) xmax = points[i].x;
+	}
+
+	int k = num_strip;
+	long long width = (long long) xmax - xmin + 1;
+	if (k > width)
+		k = (int) width;
+
+	// 띠마다 y가 가장 작은 점, 가장 큰 점의 index (-1 : 빈 띠)
+	// bottom[k], top[k] 는 x == xmin, bottom[k+1], top[k+1] 은 x == xmax 인 점들
+	int *bottom = (int *) malloc( 2 * (k + 2) * sizeof(int));
+	int *top = bottom + k + 2;
+	assert( bottom != NULL);
+
+	for (int s = 0; s < k + 2; s++)
+		bottom[s] = top[s] = -1;
+
+	for (int i = 0; i < num_point; i++)
+	{
+		t_point p = points[i];
+		int s = (int)((t_wide)((long long) p.x - xmin) * k / width);
+		int e = (p.x == xmin) ? k : (p.x == xmax) ? k + 1 : -1;
+
+		for (int r = 0; r < 2 && s >= 0; r++, s = e)
+		{
+			if (bottom[s] < 0 || p.y < points[bottom[s]].y) bottom[s] = i;
+			if (top[s] < 0 || p.y > points[top[s]].y) top[s] = i;
+		}
+	}
+
+	// 후보들의 convex hull
+	t_point *candidate = (t_point *) malloc( (4 * (k + 2) + 2) * sizeof(t_point));
+	assert( candidate != NULL);
+
+	int n = 0;
+	for (int s = 0; s < k + 2; s++)
+	{
+		if (bottom[s] < 0) continue;
+		candidate[n++] = points[bottom[s]];
+		if (top[s] != bottom[s])
+			candidate[n++] = points[top[s]];
+	}
+	qsort( candidate, n, sizeof(t_point), cmp_x);
+
+	t_point *hull = candidate + n;
+	int h = monotone_chain( candidate, n, hull);
+
+	t_line *lines = (t_line *) malloc( (h + 1) * sizeof(t_line));
+	assert( lines != NULL);
+	*num_line = ring_to_lines( hull, h, lines);
+
+	// 띠의 폭이 1이면 (k == width) 모든 x에서 y가 가장 작은/큰 점이 남으므로 정확한 convex hull
+	approx_error = (k == width) ? 0 : ((double) xmax - xmin) / k;
+
+	free( bottom);
+	free( candidate);
+
+	return lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 작은 convex hull 여러 개를 한 번에 (CSR 형식)
+// 그룹 g의 점들은 points[offset[g]] ~ points[offset[g+1]-1]
+// 스레드마다 작업 공간(arena)을 하나씩 두고 가장 큰 그룹에 맞게 키워가며 재사용하므로 그룹마다 메모리를 할당하지 않고,
+// 그룹들은 BATCH_CHUNK 개씩 스레드들이 가져가서 monotone chain으로 처리한다.
+// 그룹의 convex hull은 꼭짓점이 그룹의 점의 수를 넘지 않으므로 먼저 출력 배열의 offset[g] 위치에 쓰고 마지막에 앞으로 모음
+#define BATCH_CHUNK	64
+
+// 크기가 job_size인 작업 num_job 개를 동시에 실행
+// jobs[0]은 현재 스레드에서, 나머지는 새 스레드에서 실행
+static void run_jobs( void *(*func)(void *), void *jobs, size_t job_size, int num_job)
+{
+	pthread_t threads[MAX_THREAD];
+	char *job = (char *) jobs;
+
+	for (int i = 1; i < num_job; i++)
+		pthread_create( &threads[i], NULL, func, job + i * job_size);
+	func( job);
+	for (int i = 1; i < num_job; i++)
+		pthread_join( threads[i], NULL);
+}
+
+typedef struct
+{
+	const t_point *points;
+	const int *offset;
+	int num_group;
+	atomic_int *next;	// 다음에 처리할 그룹
+
+	t_point *hull;		// 그룹 g의 꼭짓점들은 hull[offset[g]] 부터
+	int *count;			// 그룹 g의 꼭짓점 수
+
+	t_point *arena;		// 스레드의 작업 공간 (정렬한 점들 + 꼭짓점들)
+	int arena_size;
+} t_batch_job;
+
+static void *batch_job( void *arg)
+{
+	t_batch_job *job = (t_batch_job *) arg;
+	int first;
+
+	while ((first = atomic_fetch_add( job->next, BATCH_CHUNK)) < job->num_group)
+	{
+		int last = (first + BATCH_CHUNK < job->num_group) ? first + BATCH_CHUNK : job->num_group;
+
+		for (int g = first; g < last; g++)
+		{
+			int lo = job->offset[g];
+			int n = job->offset[g+1] - lo;
+
+			job->count[g] = 0;
+			if (n <= 0)
+				continue;
+
+			if (job->arena_size < 2 * n + 2)
+			{
+				job->arena_size = (2 * job->arena_size > 2 * n + 2) ? 2 * job->arena_size : 2 * n + 2;
+				job->arena = (t_point *) realloc( job->arena, job->arena_size * sizeof(t_point));
+				assert( job->arena != NULL);
+			}
+
+			memcpy( job->arena, job->points + lo, n * sizeof(t_point));
+			qsort( job->arena, n, sizeof(t_point), cmp_x);
+
+			int k = monotone_chain( job->arena, n, job->arena + n);
+			memcpy( job->hull + lo, job->arena + n, k * sizeof(t_point));
+			job->count[g] = k;
+		}
+	}
+	return NULL;
+}
+
+// [input] points : 모든 그룹의 점들 (바꾸지 않음)
+// [input] offset : 그룹들의 시작 위치 (num_group + 1 개, offset[num_group] = 전체 점의 수)
+// [input] num_group : 그룹의 수
+// [output] hull_offset : 그룹 g의 convex hull은 hull[hull_offset[g]] ~ hull[hull_offset[g+1]-1] (num_group + 1 개의 공간)
+// return value : 모든 그룹의 convex hull 꼭짓점들 (그룹마다 가장 왼쪽(아래)의 점부터 반시계 방향)
+t_point *convex_hull_batch( const t_point *points, const int *offset, int num_group, int *hull_offset)
+{
+	int total = offset[num_group] - offset[0];
+	t_point *hull = (t_point *) malloc( (offset[num_group] + 1) * sizeof(t_point));
+	int *count = (int *) malloc( (num_group + 1) * sizeof(int));
+	assert( hull != NULL && count != NULL);
+
+	atomic_int next = 0;
+	t_batch_job jobs[MAX_THREAD];
+	int num_job = (total > PAR_TASK_CUTOFF && num_group > BATCH_CHUNK) ? num_thread : 1;
+
+	for (int i = 0; i < num_job; i++)
+		jobs[i] = (t_batch_job){ points, offset, num_group, &next, hull, count, NULL, 0};
+	run_jobs( batch_job, jobs, sizeof(t_batch_job), num_job);
+	for (int i = 0; i < num_job; i++)
+		free( jobs[i].arena);
+
+	// 앞으로 모음 (hull_offset[g] <= offset[g] 이므로 뒤쪽 그룹을 덮어쓰지 않음)
+	hull_offset[0] = 0;
+	for (int g = 0; g < num_group; g++)
+	{
+		memmove( hull + hull_offset[g], hull + offset[g], count[g] * sizeof(t_point));
+		hull_offset[g+1] = hull_offset[g] + count[g];
+	}
+	free( count);
+
+	return (t_point *) realloc( hull, (hull_offset[num_group] + 1) * sizeof(t_point));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// LSD radix sort
+// (x, y)를 64비트 키 하나로 묶어 (부호 비트를 뒤집어 부호 없는 정수의 순서가 되도록) 8비트씩 8번 정렬
+// 모든 키에서 같은 값인 자릿수는 건너뛰므로, 좌표의 범위가 작으면 정렬 횟수가 줄어든다. (RANGE 10000: 4번)
+// cmp_x와 같은 (x, y) 순서로 정렬됨
+#define RADIX_BITS	8
+#define RADIX_SIZE	(1 << RADIX_BITS)
+#define RADIX_PASS	8
+
+static unsigned long long radix_key( t_point p)
+{
+	return ((unsigned long long)((unsigned int) p.x ^ 0x80000000u) << 32) | ((unsigned int) p.y ^ 0x80000000u);
+}
+
+typedef struct
+{
+	t_point *points;
+	int lo, hi;
+	int count[RADIX_PASS][RADIX_SIZE];
+} t_radix_job;
+
+// 구간의 점들에 대해 모든 자릿수의 히스토그램을 한 번에 구함
+static void *histogram_job( void *arg)
+{
+	t_radix_job *job = (t_radix_job *) arg;
+
+	memset( job->count, 0, sizeof(job->count));
+	for (int i = job->lo; i < job->hi; i++)
+	{
+		unsigned long long key = radix_key( job->points[i]);
+		for (int d = 0; d < RADIX_PASS; d++)
+			job->count[d][(key >> (d * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+	}
+	return NULL;
+}
+
+// 점들을 (x, y) 순서로 정렬 (스레드가 여럿이면 히스토그램을 나누어 구함)
+void radix_sort( t_point *points, int num_point)
+{
+	int num_job = (num_thread > 1 && num_point > PAR_TASK_CUTOFF) ? num_thread : 1;
+	t_radix_job *jobs = (t_radix_job *) malloc( num_job * sizeof(t_radix_job));
+	t_point *scratch = (t_point *) malloc( num_point * sizeof(t_point));
+	assert( jobs != NULL && scratch != NULL);
+
+	for (int i = 0; i < num_job; i++)
+	{
+		jobs[i].points = points;
+		jobs[i].lo = (int)((long long) num_point * i / num_job);
+		jobs[i].hi = (int)((long long) num_point * (i + 1) / num_job);
+	}
+	run_jobs( histogram_job, jobs, sizeof(t_radix_job), num_job);
+
+	t_point *src = points;
+	t_point *dst = scratch;
+
+	for (int d = 0; d < RADIX_PASS; d++)
+	{
+		int offset[RADIX_SIZE];
+		int sum = 0;
+		int skip = 0;
+
+		for (int b = 0; b < RADIX_SIZE; b++)
+		{
+			int count = 0;
+			for (int i = 0; i < num_job; i++)
+				count += jobs[i].count[d][b];
+			if (count == num_point)
+				skip = 1;
+			offset[b] = sum;
+			sum += count;
+		}
+		if (skip) continue;
+
+		for (int i = 0; i < num_point; i++)
+			dst[offset[(radix_key( src[i]) >> (d * RADIX_BITS)) & (RADIX_SIZE - 1)]++] = src[i];
+
+		t_point *tmp = src; src = dst; dst = tmp;
+	}
+
+	if (src != points)
+		memcpy( points, src, num_point * sizeof(t_point));
+
+	free( scratch);
+	free( jobs);
+}
+
+static void qsort_x( t_point *points, int num_point)
+{
+	qsort( points, num_point, sizeof(t_point), cmp_x);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 정렬 알고리즘 목록 (모두 cmp_x의 (x, y) 순서로 정렬)
+typedef void (*t_sort_func)( t_point *points, int num_point);
+
+typedef struct
+{
+	const char *name;
+	t_sort_func func;
+} t_sorter;
+
+static const t_sorter sorters[] =
+{
+	{ "qsort", qsort_x},
+	{ "radix", radix_sort},
+};
+
+#define NUM_SORTER (int)(sizeof(sorters) / sizeof(sorters[0]))
+
+// 이름으로 정렬 알고리즘을 찾는 함수
+// return value : 알고리즘의 포인터, 없는 경우 NULL
+static const t_sorter *find_sorter( const char *name)
+{
+	for (int i = 0; i < NUM_SORTER; i++)
+		if (strcmp( sorters[i].name, name) == 0)
+			return &sorters[i];
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// C++ hull 코어 (common/hull_core.hpp)의 전처리 -> 정렬 -> monotone chain
+// 출력 버퍼의 뒤쪽 절반을 꼭짓점 목록으로 사용 (convex_hull_monotone과 같음)
+
+// 꼭짓점들을 선들로 (꼭짓점이 없으면 선도 없음)
+static int core_lines( t_point *hull, int k, t_line *lines)
+{
+	return (k > 0) ? ring_to_lines( hull, k, lines) : 0;
+}
+
+// 정확한 방향 판정 (모든 int 좌표)
+t_line *convex_hull_core( t_point *points, int num_point, int *num_line)
+{
+	t_line *lines = (t_line *) malloc( (num_point + 2) * sizeof(t_line));
+	assert( lines != NULL);
+
+	t_point *hull = (t_point *) lines + (num_point + 2);
+	*num_line = core_lines( hull, hull_core_int( points, num_point, hull), lines);
+	return lines;
+}
+
+// 빠른 방향 판정 (좌표의 절댓값이 2^30 보다 작을 때만 정확)
+t_line *convex_hull_core_fast( t_point *points, int num_point, int *num_line)
+{
+	t_line *lines = (t_line *) malloc( (num_point + 2) * sizeof(t_line));
+	assert( lines != NULL);
+
+	t_point *hull = (t_point *) lines + (num_point + 2);
+	*num_line = core_lines( hull, hull_core_int_fast( points, num_point, hull), lines);
+	return lines;
+}
+
+// int 좌표를 double로 바꾸어 hull_core_double로 계산
+// int 좌표는 double로 정확히 나타내어지므로 결과는 convex_hull_core와 같아야 함
+t_line *convex_hull_core_double( t_point *points, int num_point, int *num_line)
+{
+	t_line *lines = (t_line *) malloc( (num_point + 2) * sizeof(t_line));
+	double *xy = (double *) malloc( 2 * (size_t) num_point * sizeof(double));
+	double *vertex = (double *) malloc( 2 * ((size_t) num_point + 2) * sizeof(double));
+	assert( lines != NULL && xy != NULL && vertex != NULL);
+
+	for (int i = 0; i < num_point; i++)
+	{
+		xy[2*i] = points[i].x;
+		xy[2*i+1] = points[i].y;
+	}
+	int k = hull_core_double( xy, num_point, vertex);
+
+	// 꼭짓점은 입력 점이므로 다시 int로 정확히 바뀌어야 함
+	t_point *hull = (t_point *) lines + (num_point + 2);
+	for (int i = 0; i < k; i++)
+	{
+		hull[i].x = (int) vertex[2*i];
+		hull[i].y = (int) vertex[2*i+1];
+		assert( hull[i].x == vertex[2*i] && hull[i].y == vertex[2*i+1]);
+	}
+	*num_line = core_lines( hull, k, lines);
+
+	free( xy);
+	free( vertex);
+	return lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// convex hull 알고리즘 목록
+typedef t_line *(*t_hull_func)( t_point *points, int num_point, int *num_line);
+
+typedef struct
+{
+	const char *name;
+	t_hull_func func;
+} t_engine;
+
+static const t_engine engines[] =
+{
+	{ "quickhull", convex_hull},
+	{ "inplace", convex_hull_inplace},
+	{ "parallel", convex_hull_parallel},
+	{ "soa", convex_hull_soa},
+	{ "monotone", convex_hull_monotone},
+	{ "chan", convex_hull_chan},
+	{ "incremental", convex_hull_incremental},
+	{ "approx", convex_hull_approx},
+	{ "core", convex_hull_core},
+	{ "core-fast", convex_hull_core_fast},
+	{ "core-double", convex_hull_core_double},
+};
+
+#define NUM_ENGINE (int)(sizeof(engines) / sizeof(engines[0]))
+
+// 이름으로 convex hull 알고리즘을 찾는 함수
+// return value : 알고리즘의 포인터, 없는 경우 NULL
+static const t_engine *find_engine( const char *name)
+{
+	for (int i = 0; i < NUM_ENGINE; i++)
+		if (strcmp( engines[i].name, name) == 0)
+			return &engines[i];
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 출력
+// r : Rscript (기본), csv : 점들과 convex hull 순서, bin : hull_io.h의 바이너리 형식
+// r, csv 형식은 budget 만큼의 내부 점만 고르게 골라서 출력할 수 있으며, convex hull의 꼭짓점은 항상 출력함
+#define OUTPUT_R	0
+#define OUTPUT_CSV	1
+#define OUTPUT_BIN	2
+
+static const char *output_names[] = { "r", "csv", "bin"};
+
+// return value : 출력 형식, 없는 경우 -1
+static int find_output( const char *name)
+{
+	for (int i = 0; i < (int)(sizeof(output_names) / sizeof(output_names[0])); i++)
+		if (strcmp( output_names[i], name) == 0)
+			return i;
+	return -1;
+}
+
+static int cmp_line_from( const void *p1, const void *p2)
+{
+	return cmp_x( &((t_line *)p1)->from, &((t_line *)p2)->from);
+}
+
+// 선들(convex hull)을 가장 왼쪽(아래)의 점부터 반시계 방향의 꼭짓점 목록으로 바꾸는 함수
+// 엔진에 따라 선들의 순서와 방향이 다르므로 (quickhull: 시계 방향, parallel: 순서 없음) 각 선의 끝 점에서 시작하는 선을 찾아 이어감
+// [output] ring : 꼭짓점 (num_line 개의 공간이 있어야 함)
+// return value : 꼭짓점의 수
+int lines_to_ring( t_line *lines, int num_line, t_point *ring)
+{
+	t_line *sorted = (t_line *) malloc( num_line * sizeof(t_line));
+	assert( sorted != NULL);
+
+	memcpy( sorted, lines, num_line * sizeof(t_line));
+	qsort( sorted, num_line, sizeof(t_line), cmp_line_from);
+
+	t_point first = sorted[0].from;
+	t_point p = first;
+	int k = 0;
+
+	while (k < num_line)
+	{
+		ring[k++] = p;
+
+		t_line key = { p, p};
+		t_line *line = (t_line *) bsearch( &key, sorted, num_line, sizeof(t_line), cmp_line_from);
+		assert( line != NULL);
+
+		p = line->to;
+		if (p.x == first.x && p.y == first.y)
+			break;
+	}
+	free( sorted);
+
+	// 시계 방향이면 뒤집음
+	t_wide area = 0;
+	for (int i = 1; i + 1 < k; i++)
+		area += orient2d( ring[0], ring[i], ring[i+1]);
+	if (area < 0)
+	{
+		for (int i = 1, j = k - 1; i < j; i++, j--)
+		{
+			t_point tmp = ring[i]; ring[i] = ring[j]; ring[j] = tmp;
+		}
+	}
+	return k;
+}
+
+typedef struct
+{
+	t_point p;
+	int order; // ring에서의 순서
+} t_ring_vertex;
+
+static int cmp_ring_vertex( const void *p1, const void *p2)
+{
+	return cmp_x( &((t_ring_vertex *)p1)->p, &((t_ring_vertex *)p2)->p);
+}
+
+// ring의 각 꼭짓점이 points의 몇 번째 점인지 구하는 함수 (같은 점이 여럿이면 가장 앞의 점)
+// [output] hull : 꼭짓점의 index (ring의 순서)
+void ring_to_index( t_point *points, int num_point, t_point *ring, int num_hull, int *hull)
+{
+	t_ring_vertex *sorted = (t_ring_vertex *) malloc( num_hull * sizeof(t_ring_vertex));
+	assert( sorted != NULL);
+
+	for (int i = 0; i < num_hull; i++)
+	{
+		sorted[i].p = ring[i];
+		sorted[i].order = i;
+		hull[i] = -1;
+	}
+	qsort( sorted, num_hull, sizeof(t_ring_vertex), cmp_ring_vertex);
+
+	for (int i = 0; i < num_point; i++)
+	{
+		t_ring_vertex key = { points[i], 0};
+		t_ring_vertex *v = (t_ring_vertex *) bsearch( &key, sorted, num_hull, sizeof(t_ring_vertex), cmp_ring_vertex);
+		if (v != NULL && hull[v->order] < 0)
+			hull[v->order] = i;
+	}
+	free( sorted);
+}
+
+// 출력할 점들을 고르는 함수
+// convex hull의 꼭짓점은 모두, 나머지 점들은 budget 개 이하가 되도록 일정한 간격으로 고름 (budget이 음수이면 모두)
+// [output] order : 출력할 점은 ring에서의 순서(내부 점은 -1), 출력하지 않을 점은 -2
+static void select_points( int num_point, int *hull, int num_hull, int budget, int *order)
+{
+	long long num_interior = num_point;
+	long long step = 1;
+
+	for (int i = 0; i < num_point; i++)
+		order[i] = -1;
+	for (int i = 0; i < num_hull; i++)
+	{
+		order[hull[i]] = i;
+		num_interior--;
+	}
+
+	if (budget >= 0)
+		step = (budget == 0) ? num_interior + 1 : (num_interior + budget - 1) / budget;
+
+	long long seen = 0, taken = 0;
+	for (int i = 0; i < num_point; i++)
+	{
+		if (order[i] != -1) continue;
+		if (budget >= 0 && (seen++ % step != 0 || taken >= budget))
+			order[i] = -2;
+		else
+			taken++;
+	}
+}
+
+// 선택된 점들만 출력
+static void print_selected_points( t_point *points, int num_point, int *order)
+{
+	printf( "\n#points\n");
+
+	for (int i = 0; i < num_point; i++)
+		if (order[i] != -2)
+			printf( "points(%d,%d)\n", points[i].x, points[i].y);
+}
+
+// x,y,hull (hull : convex hull에서의 순서, 내부 점은 -1)
+static void print_csv( t_point *points, int num_point, int *order)
+{
+	printf( "x,y,hull\n");
+
+	for (int i = 0; i < num_point; i++)
+		if (order[i] != -2)
+			printf( "%d,%d,%d\n", points[i].x, points[i].y, order[i]);
+}
+
+// 점들과 convex hull을 주어진 형식으로 stdout에 출력
+// (stdout에 아무것도 출력하기 전에 호출해야 함)
+void write_output( int output, t_point *points, int num_point, t_line *lines, int num_line, int budget)
+{
+	static char buffer[1 << 20];
+
+	// 점마다 printf 하므로 stdout의 버퍼를 크게 잡음
+	setvbuf( stdout, buffer, _IOFBF, sizeof(buffer));
+
+	// 모든 점을 출력하는 Rscript는 꼭짓점 정보가 필요 없음
+	if (output == OUTPUT_R && budget < 0)
+	{
+		print_header( "convex.png");
+		print_points( points, num_point);
+		print_line_segments( lines, num_line);
+		print_footer();
+		return;
+	}
+
+	t_point *ring = (t_point *) malloc( num_line * sizeof(t_point));
+	int *hull = (int *) malloc( num_line * sizeof(int));
+	assert( ring != NULL && hull != NULL);
+
+	int num_hull = lines_to_ring( lines, num_line, ring);
+	ring_to_index( points, num_point, ring, num_hull, hull);
+
+	if (output == OUTPUT_BIN)
+	{
+		fflush( stdout);
+		if (write_hull( STDOUT_FILENO, points, num_point, hull, num_hull) < 0)
+			perror( "write_hull");
+	}
+	else
+	{
+		int *order = (int *) malloc( num_point * sizeof(int));
+		assert( order != NULL);
+
+		select_points( num_point, hull, num_hull, budget, order);
+		if (output == OUTPUT_CSV)
+			print_csv( points, num_point, order);
+		else
+		{
+			print_header( "convex.png");
+			print_selected_points( points, num_point, order);
+			print_line_segments( lines, num_line);
+			print_footer();
+		}
+		free( order);
+	}
+
+	free( ring);
+	free( hull);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 스트리밍 convex hull
+// 점들을 chunk 개씩 읽어 (지금까지의 convex hull의 꼭짓점 + 새로 읽은 점들)의 convex hull을 구하는 것을 반복
+// convex hull의 꼭짓점만 다음 chunk로 넘기므로 메모리는 O(h + chunk)
+// approx는 chunk마다 근사하면 근사한 꼭짓점을 다시 근사하여 오차가 쌓이므로, chunk마다 monotone chain으로 정확한 convex hull을 구하고
+// 마지막에 그 꼭짓점들을 한 번만 근사함 (정확한 convex hull의 점들은 모두 꼭짓점들보다 근사 convex hull에 가까우므로
+// 띠의 폭이 전체 점들에 대한 오차 한계이며, 꼭짓점들의 x 범위는 전체 점들과 같으므로 띠의 폭도 같음)
+#define STREAM_CHUNK	(1 << 20)
+
+// [output] hull : 최종 convex hull의 꼭짓점들 (반시계 방향, 호출한 쪽에서 free)
+//			num_hull, num_read : 읽은 점의 수, num_line
+// return value : lines, 읽은 점이 없으면 NULL
+t_line *convex_hull_stream( t_point_reader *reader, int chunk, const t_engine *engine, const t_sorter *sorter, int prefilter, t_point **hull, int *num_hull, long long *num_read, int *num_line)
+{
+	int capacity = chunk;
+	t_point *work = (t_point *) malloc( capacity * sizeof(t_point));
+	assert( work != NULL);
+
+	t_line *lines = NULL;
+	int carry = 0; // work 앞쪽의 이전 convex hull 꼭짓점 수
+	int approx = (engine->func == convex_hull_approx);
+	t_hull_func func = approx ? convex_hull_monotone : engine->func;
+	int n;
+
+	*num_read = 0;
+	*num_line = 0;
+	while ((n = point_reader_read( reader, work + carry, chunk)) > 0)
+	{
+		*num_read += n;
+		n += carry;
+
+		if (prefilter)
+			n = akl_toussaint( work, n);
+		sorter->func( work, n);
+
+		free( lines);
+		lines = func( work, n, num_line);
+
+		// 다음 chunk를 읽을 공간 확보
+		if (capacity < *num_line + chunk)
+		{
+			capacity = *num_line + chunk;
+			work = (t_point *) realloc( work, capacity * sizeof(t_point));
+			assert( work != NULL);
+		}
+		carry = lines_to_ring( lines, *num_line, work);
+	}
+
+	if (approx && lines != NULL)
+	{
+		free( lines);
+		lines = convex_hull_approx( work, carry, num_line);
+		carry = lines_to_ring( lines, *num_line, work);
+	}
+
+	*hull = work;
+	*num_hull = carry;
+	return lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void print_usage( char *program)
+{
+	printf( "%s [-e engine] [-s sort] [-t number_of_threads] [-f] [-k number_of_strips] [-r range] [-S seed] [-g distribution] [-o r|csv|bin] [-d budget] [-q number_of_queries] number_of_points\n", program);
+	printf( "%s -G group_size [-t number_of_threads] [-r range] [-S seed] [-g distribution] number_of_points\n", program);
+	printf( "%s -w window_size [-p step] [-r range] [-S seed] [-g distribution] [-o r|csv|bin] [-d budget] [-q number_of_queries] number_of_points\n", program);
+	printf( "%s [-e engine] [-s sort] [-t number_of_threads] [-f] [-k number_of_strips] [-o r|csv|bin] [-c chunk] [-q number_of_queries] -i file|-\n", program);
+	printf( "%s -b csv|json [-e engine] [-s sort] [-t number_of_threads] [-r range] [-S seed] [-x bruteforce_program] [-R baseline.csv] [-T threshold] max_number_of_points\n", program);
+	printf( "engines:");
+	for (int i = 0; i < NUM_ENGINE; i++)
+		printf( " %s", engines[i].name);
+	printf( "\n");
+	printf( "sorts:");
+	for (int i = 0; i < NUM_SORTER; i++)
+		printf( " %s", sorters[i].name);
+	printf( "\n");
+	printf( "distributions:");
+	for (int i = 0; i < POINTGEN_NUM_DIST; i++)
+		printf( " %s", pointgen_names[i]);
+	printf( "\n");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// convex hull 질의
+// lines_to_ring으로 만든 반시계 방향 꼭짓점 목록(ring, 꼭짓점 수 k)에 대한 질의
+// 포함 판정은 ring[0]을 중심으로 한 부채꼴(wedge)을 이분 탐색하여 O(log h),
+// 지름, 폭, 최소 넓이 직사각형은 rotating calipers로 O(h)
+
+// 점 q가 convex hull의 안(변 위 포함)에 있는지 판정
+// ring[0]에서 본 q의 방향이 ring[i], ring[i+1] 사이가 되는 i를 이분 탐색으로 찾아 삼각형 (ring[0], ring[i], ring[i+1])로 판정
+// return value : 안이면 1, 밖이면 0
+int hull_contains( const t_point *ring, int k, t_point q)
+{
+	if (k == 1)
+		return q.x == ring[0].x && q.y == ring[0].y;
+
+	if (k == 2)
+		return orient2d_sign( ring[0], ring[1], q) == 0
+			&& !is_before( q, ring[0]) && !is_before( ring[1], q);
+
+	// ring[0]->ring[1] 의 오른쪽이나 ring[0]->ring[k-1] 의 왼쪽이면 밖
+	if (orient2d_sign( ring[0], ring[1], q) < 0 || orient2d_sign( ring[0], ring[k-1], q) > 0)
+		return 0;
+
+	// ring[0]->ring[lo] 의 왼쪽(또는 위)인 가장 큰 lo (1 <= lo <= k-2)
+	int lo = 1, hi = k - 1;
+	while (hi - lo > 1)
+	{
+		int mid = (lo + hi) / 2;
+		if (orient2d_sign( ring[0], ring[mid], q) >= 0)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return orient2d_sign( ring[lo], ring[lo+1], q) >= 0;
+}
+
+#ifdef USE_AVX2
+// 좌표가 모두 SOA_INT32_LIMIT 보다 작을 때 (o, a, b)의 방향을 32비트 정수로 계산
+__attribute__((target("avx2")))
+static inline __m256i orient_avx2( __m256i ox, __m256i oy, __m256i ax, __m256i ay, __m256i bx, __m256i by)
+{
+	__m256i dax = _mm256_sub_epi32( ax, ox);
+	__m256i day = _mm256_sub_epi32( ay, oy);
+	__m256i dbx = _mm256_sub_epi32( bx, ox);
+	__m256i dby = _mm256_sub_epi32( by, oy);
+
+	return _mm256_sub_epi32( _mm256_mullo_epi32( dax, dby), _mm256_mullo_epi32( day, dbx));
+}
+
+// hull_contains를 8개의 질의에 대해 한 번에 (이분 탐색은 gather로 분기 없이 고정된 횟수만큼)
+// rx, ry : ring의 좌표 (k >= 3, 모든 좌표의 절댓값 < SOA_INT32_LIMIT)
+// 좌표가 범위 밖인 질의가 섞인 8개는 hull_contains로 처리
+// return value : 처리한 질의의 수 (8의 배수)
+__attribute__((target("avx2")))
+static int contains_avx2( const t_point *ring, const int *rx, const int *ry, int k, const t_point *query, int n, unsigned char *inside)
+{
+	__m256i zero = _mm256_setzero_si256();
+	__m256i one = _mm256_set1_epi32( 1);
+	__m256i last = _mm256_set1_epi32( k - 2);
+	__m256i limit = _mm256_set1_epi32( SOA_INT32_LIMIT);
+	__m256i limit2 = _mm256_set1_epi32( 2 * SOA_INT32_LIMIT - 1);
+	__m256i index2 = _mm256_setr_epi32( 0, 2, 4, 6, 8, 10, 12, 14);
+	__m256i r0x = _mm256_set1_epi32( rx[0]), r0y = _mm256_set1_epi32( ry[0]);
+	__m256i r1x = _mm256_set1_epi32( rx[1]), r1y = _mm256_set1_epi32( ry[1]);
+	__m256i rlx = _mm256_set1_epi32( rx[k-1]), rly = _mm256_set1_epi32( ry[k-1]);
+	int top = 1;
+	int i;
+
+	while (top * 2 <= k - 2)
+		top *= 2;
+
+	for (i = 0; i + 8 <= n; i += 8)
+	{
+		const int *base = (const int *)(query + i);
+		__m256i qx = _mm256_i32gather_epi32( base, index2, 4);
+		__m256i qy = _mm256_i32gather_epi32( base + 1, index2, 4);
+
+		// |좌표| < SOA_INT32_LIMIT  <=>  (unsigned)(좌표 + SOA_INT32_LIMIT) <= 2 * SOA_INT32_LIMIT - 1
+		__m256i u = _mm256_max_epu32( _mm256_add_epi32( qx, limit), _mm256_add_epi32( qy, limit));
+		if (_mm256_movemask_epi8( _mm256_cmpeq_epi32( _mm256_max_epu32( u, limit2), limit2)) != -1)
+		{
+			for (int j = i; j < i + 8; j++)
+				inside[j] = hull_contains( ring, k, query[j]);
+			continue;
+		}
+
+		// 부채꼴 안 : ring[0]->ring[1] 의 오른쪽이 아니고 ring[0]->ring[k-1] 의 왼쪽이 아님
+		__m256i in = _mm256_andnot_si256(
+			_mm256_or_si256(
+				_mm256_cmpgt_epi32( zero, orient_avx2( r0x, r0y, r1x, r1y, qx, qy)),
+				_mm256_cmpgt_epi32( orient_avx2( r0x, r0y, rlx, rly, qx, qy), zero)),
+			_mm256_set1_epi32( -1));
+
+		__m256i lo = one;
+		for (int step = top; step > 0; step /= 2)
+		{
+			__m256i cand = _mm256_add_epi32( lo, _mm256_set1_epi32( step));
+			__m256i valid = _mm256_cmpgt_epi32( _mm256_add_epi32( last, one), cand);
+			__m256i ci = _mm256_min_epi32( cand, last);
+			__m256i cx = _mm256_i32gather_epi32( rx, ci, 4);
+			__m256i cy = _mm256_i32gather_epi32( ry, ci, 4);
+			__m256i right = _mm256_cmpgt_epi32( zero, orient_avx2( r0x, r0y, cx, cy, qx, qy));
+
+			lo = _mm256_blendv_epi8( lo, cand, _mm256_andnot_si256( right, valid));
+		}
+
+		__m256i hi = _mm256_add_epi32( lo, one);
+		__m256i ax = _mm256_i32gather_epi32( rx, lo, 4);
+		__m256i ay = _mm256_i32gather_epi32( ry, lo, 4);
+		__m256i bx = _mm256_i32gather_epi32( rx, hi, 4);
+		__m256i by = _mm256_i32gather_epi32( ry, hi, 4);
+		in = _mm256_andnot_si256( _mm256_cmpgt_epi32( zero, orient_avx2( ax, ay, bx, by, qx, qy)), in);
+
+		int mask = _mm256_movemask_ps( _mm256_castsi256_ps( in));
+		for (int j = 0; j < 8; j++)
+			inside[i+j] = (mask >> j) & 1;
+	}
+	return i;
+}
+#endif
+
+// n 개의 질의 점들에 대한 포함 판정
+// AVX2를 지원하고 ring의 좌표가 작으면 (SOA_INT32_LIMIT) 8개씩 벡터로, 그 외에는 hull_contains로
+// [output] inside : 질의마다 안이면 1, 밖이면 0
+void hull_contains_batch( const t_point *ring, int k, const t_point *query, int n, unsigned char *inside)
+{
+	int i = 0;
+
+#ifdef USE_AVX2
+	__builtin_cpu_init();
+	if (k >= 3 && __builtin_cpu_supports( "avx2"))
+	{
+		int *rx = (int *) malloc( 2 * k * sizeof(int));
+		int *ry = rx + k;
+		int small = 1;
+		assert( rx != NULL);
+
+		for (int j = 0; j < k; j++)
+		{
+			rx[j] = ring[j].x;
+			ry[j] = ring[j].y;
+			small &= (rx[j] > -SOA_INT32_LIMIT && rx[j] < SOA_INT32_LIMIT && ry[j] > -SOA_INT32_LIMIT && ry[j] < SOA_INT32_LIMIT);
+		}
+		if (small)
+			i = contains_avx2( ring, rx, ry, k, query, n, inside);
+		free( rx);
+	}
+#endif
+
+	for (; i < n; i++)
+		inside[i] = hull_contains( ring, k, query[i]);
+}
+
+// 두 벡터 a->b, c->d 의 내적
+static inline t_wide dot2d( t_point a, t_point b, t_point c, t_point d)
+{
+	t_wide abx = (long long) b.x - a.x;
+	t_wide aby = (long long) b.y - a.y;
+	t_wide cdx = (long long) d.x - c.x;
+	t_wide cdy = (long long) d.y - c.y;
+
+	return abx * cdx + aby * cdy;
+}
+
+// 지름 (가장 먼 두 꼭짓점)
+// 변 ring[i]->ring[i+1] 마다 그 변에서 가장 먼 꼭짓점 j를 (i가 증가하면 j도 증가) 찾아 (i, j), (i+1, j)를 비교
+// [output] a, b : 가장 먼 두 꼭짓점의 index
+// return value : 거리의 제곱
+t_wide hull_diameter( const t_point *ring, int k, int *a, int *b)
+{
+	t_wide max = 0;
+
+	*a = *b = 0;
+	if (k == 2)
+	{
+		*b = 1;
+		return dist2( ring[0], ring[1]);
+	}
+	if (k < 3)
+		return 0;
+
+	for (int i = 0, j = 1; i < k; i++)
+	{
+		int ni = (i + 1) % k;
+
+		while (orient2d( ring[i], ring[ni], ring[(j+1)%k]) > orient2d( ring[i], ring[ni], ring[j]))
+			j = (j + 1) % k;
+
+		if (dist2( ring[i], ring[j]) > max)
+		{
+			max = dist2( ring[i], ring[j]);
+			*a = i;
+			*b = j;
+		}
+		if (dist2( ring[ni], ring[j]) > max)
+		{
+			max = dist2( ring[ni], ring[j]);
+			*a = ni;
+			*b = j;
+		}
+	}
+	return max;
+}
+
+// 폭 (평행한 두 직선 사이에 convex hull을 넣을 수 있는 최소 간격)
+// 최소 간격은 한 직선이 변과 겹칠 때이므로 변마다 가장 먼 꼭짓점까지의 거리 중 최솟값
+// [output] edge : 최소 간격일 때 직선과 겹치는 변 (ring[edge]->ring[edge+1])
+// return value : 폭 (꼭짓점이 2개 이하이면 0)
+double hull_width( const t_point *ring, int k, int *edge)
+{
+	double min = 0;
+
+	*edge = 0;
+	if (k < 3)
+		return 0;
+
+	for (int i = 0, j = 1; i < k; i++)
+	{
+		int ni = (i + 1) % k;
+
+		while (orient2d( ring[i], ring[ni], ring[(j+1)%k]) > orient2d( ring[i], ring[ni], ring[j]))
+			j = (j + 1) % k;
+
+		double width = (double) orient2d( ring[i], ring[ni], ring[j]) / sqrt( (double) dist2( ring[i], ring[ni]));
+		if (i == 0 || width < min)
+		{
+			min = width;
+			*edge = i;
+		}
+	}
+	return min;
+}
+
+typedef struct
+{
+	double area;
+	double corner[4][2];	// 반시계 방향의 네 꼭짓점 (x, y)
+} t_rect;
+
+// 최소 넓이의 (회전된) 외접 직사각형
+// 최소 넓이의 직사각형은 한 변이 convex hull의 변과 겹치므로 변마다
+// 변 방향으로 가장 먼 꼭짓점(r), 가장 뒤의 꼭짓점(l), 변에서 가장 먼 꼭짓점(j) 세 개의 caliper로 직사각형을 구함
+// return value : 최소 넓이의 직사각형 (꼭짓점이 2개 이하이면 넓이 0, 두 끝 점)
+t_rect hull_min_rect( const t_point *ring, int k)
+{
+	t_rect best;
+
+	if (k < 3)
+	{
+		best.area = 0;
+		for (int c = 0; c < 4; c++)
+		{
+			t_point p = ring[(c < 2) ? 0 : k - 1];
+			best.corner[c][0] = p.x;
+			best.corner[c][1] = p.y;
+		}
+		return best;
+	}
+
+	for (int i = 0, j = 1, r = 1, l = 0; i < k; i++)
+	{
+		t_point p = ring[i];
+		t_point q = ring[(i + 1) % k];
+
+		while (dot2d( p, q, p, ring[(r+1)%k]) > dot2d( p, q, p, ring[r]))
+			r = (r + 1) % k;
+		while (orient2d( p, q, ring[(j+1)%k]) > orient2d( p, q, ring[j]))
+			j = (j + 1) % k;
+		if (i == 0)
+			l = j;
+		while (dot2d( p, q, p, ring[(l+1)%k]) < dot2d( p, q, p, ring[l]))
+			l = (l + 1) % k;
+
+		double len2 = (double) dist2( p, q);
+		double front = (double) dot2d( p, q, p, ring[r]);
+		double back = (double) dot2d( p, q, p, ring[l]);
+		double height = (double) orient2d( p, q, ring[j]);
+		double area = height * (front - back) / len2;
+
+		if (i == 0 || area < best.area)
+		{
+			// 변 방향의 단위 벡터 u, 수직(왼쪽) 방향의 단위 벡터 v
+			double len = sqrt( len2);
+			double ux = (q.x - (double) p.x) / len, uy = (q.y - (double) p.y) / len;
+			double vx = -uy, vy = ux;
+			double s[4] = { back / len, front / len, front / len, back / len};
+			double t[4] = { 0, 0, height / len, height / len};
+
+			best.area = area;
+			for (int c = 0; c < 4; c++)
+			{
+				best.corner[c][0] = p.x + s[c] * ux + t[c] * vx;
+				best.corner[c][1] = p.y + s[c] * uy + t[c] * vy;
+			}
+		}
+	}
+	return best;
+}
+
+// 경과 시간을 재기 위한 현재 시각 (CLOCK_MONOTONIC, 초)
+static double now_sec( void)
+{
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// 임의의 점 num_query 개에 대한 포함 판정과 지름, 폭, 최소 넓이 직사각형을 구해 stderr에 출력
+// 질의 점들은 입력 점들과 같은 seed의 다른 stream으로 생성
+void run_queries( t_line *lines, int num_line, int num_query, uint64_t seed)
+{
+	t_point *ring = (t_point *) malloc( num_line * sizeof(t_point));
+	t_point *query = (t_point *) malloc( num_query * sizeof(t_point));
+	unsigned char *inside = (unsigned char *) malloc( num_query);
+	assert( ring != NULL && query != NULL && inside != NULL);
+
+	int k = lines_to_ring( lines, num_line, ring);
+
+	generate_points( query, num_query, POINTGEN_UNIFORM, seed, POINTGEN_STREAM_QUERY, range, num_thread);
+
+	double start = now_sec();
+	hull_contains_batch( ring, k, query, num_query, inside);
+	double elapsed = now_sec() - start;
+
+	int count = 0;
+	for (int i = 0; i < num_query; i++)
+		count += inside[i];
+	fprintf( stderr, "%d of %d queries inside the hull! (%.3f sec)\n", count, num_query, elapsed);
+
+	int a, b, edge;
+	t_wide diameter2 = hull_diameter( ring, k, &a, &b);
+	fprintf( stderr, "diameter : %.3f (%d,%d)-(%d,%d)\n", sqrt( (double) diameter2), ring[a].x, ring[a].y, ring[b].x, ring[b].y);
+
+	double width = hull_width( ring, k, &edge);
+	fprintf( stderr, "width : %.3f (edge (%d,%d)-(%d,%d))\n", width, ring[edge].x, ring[edge].y, ring[(edge+1)%k].x, ring[(edge+1)%k].y);
+
+	t_rect rect = hull_min_rect( ring, k);
+	fprintf( stderr, "minimum area rectangle : %.3f", rect.area);
+	for (int c = 0; c < 4; c++)
+		fprintf( stderr, " (%.2f,%.2f)", rect.corner[c][0], rect.corner[c][1]);
+	fprintf( stderr, "\n");
+
+	free( ring);
+	free( query);
+	free( inside);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 벤치마크
+// n = 10^3, 10^4, ... (max_point 이하) 와 분포마다 각 엔진을 자식 프로세스에서 실행하여
+// 정렬 + convex hull 시간(점 생성과 출력은 제외), 초당 점의 수, 최대 RSS, 선의 수를 CSV 또는 JSON으로 출력
+// brute force(assignment1)는 실행 파일의 경로가 주어지면 BRUTE_MAX_POINTS 이하에서만 실행 (점 생성 포함한 전체 시간)
+// 기준(baseline) CSV가 주어지면 같은 (엔진, 분포, n)의 초당 점의 수가 threshold(%) 넘게 줄어든 경우를 보고
+#define BENCH_MIN_POINT		1000
+#define BENCH_REPEAT		5		// 작은 n은 여러 번 실행하여 가장 빠른 시간을 사용 (측정 잡음을 줄이기 위해)
+#define BENCH_REPEAT_POINT	100000	// 이 이하의 n만 반복
+#define BRUTE_MAX_POINTS	1000	// brute force는 O(n^3)
+#define BENCH_MIN_SECONDS	0.001	// 기준 시간이 이보다 짧으면 잡음이 커서 비교하지 않음
+
+#define BENCH_CSV	0
+#define BENCH_JSON	1
+
+static const int bench_distributions[] = { POINTGEN_UNIFORM, POINTGEN_DISK, POINTGEN_CIRCLE, POINTGEN_CLUSTERED};
+
+#define NUM_BENCH_DIST (int)(sizeof(bench_distributions) / sizeof(bench_distributions[0]))
+
+typedef struct
+{
+	char engine[32];
+	char distribution[16];
+	long long num_point;
+	double seconds;
+	long peak_rss;	// KB
+	int num_line;
+} t_bench_result;
+
+// 엔진 하나를 자식 프로세스에서 실행 (엔진마다 최대 RSS를 따로 재기 위해)
+// return value : 0 성공, -1 실패 (메모리 부족 등)
+static int bench_engine( const t_engine *engine, const t_sorter *sorter, int distribution, int num_point, uint64_t seed, t_bench_result *result)
+{
+	struct { double seconds; int num_line; } msg;
+	int fd[2];
+
+	if (pipe( fd) < 0)
+		return -1;
+
+	fflush( stdout);
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		close( fd[0]);
+
+		t_point *points = (t_point *) malloc( (size_t) num_point * sizeof(t_point));
+		if (points == NULL)
+			_exit( 1);
+		generate_points( points, num_point, distribution, seed, POINTGEN_STREAM_POINT, range, num_thread);
+
+		double start = now_sec();
+		sorter->func( points, num_point);
+		t_line *lines = engine->func( points, num_point, &msg.num_line);
+		msg.seconds = now_sec() - start;
+
+		free( lines);
+		free( points);
+		_exit( write( fd[1], &msg, sizeof(msg)) == sizeof(msg) ? 0 : 1);
+	}
+	close( fd[1]);
+
+	ssize_t n = (pid > 0) ? read( fd[0], &msg, sizeof(msg)) : -1;
+	close( fd[0]);
+
+	struct rusage usage;
+	int status;
+	if (pid < 0 || wait4( pid, &status, 0, &usage) < 0 || n != sizeof(msg))
+		return -1;
+
+	snprintf( result->engine, sizeof(result->engine), "%s", engine->name);
+	snprintf( result->distribution, sizeof(result->distribution), "%s", pointgen_names[distribution]);
+	result->num_point = num_point;
+	result->seconds = msg.seconds;
+	result->peak_rss = usage.ru_maxrss;
+	result->num_line = msg.num_line;
+	return 0;
+}
+
+// brute force 실행 파일을 실행 (stdout은 버리고 stderr의 "... lines created!" 에서 선의 수를 읽음)
+// return value : 0 성공, -1 실패
+static int bench_brute( const char *path, int distribution, int num_point, uint64_t seed, t_bench_result *result)
+{
+	char seed_arg[32], range_arg[16], num_arg[16];
+	char buf[4096];
+	int fd[2];
+
+	snprintf( seed_arg, sizeof(seed_arg), "%llu", (unsigned long long) seed);
+	snprintf( range_arg, sizeof(range_arg), "%d", range);
+	snprintf( num_arg, sizeof(num_arg), "%d", num_point);
+
+	if (pipe( fd) < 0)
+		return -1;
+
+	fflush( stdout);
+	double start = now_sec();
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		int null = open( "/dev/null", O_WRONLY);
+		dup2( null, STDOUT_FILENO);
+		dup2( fd[1], STDERR_FILENO);
+		close( fd[0]);
+		execl( path, path, "-S", seed_arg, "-g", pointgen_names[distribution], "-r", range_arg, num_arg, (char *) NULL);
+		_exit( 127);
+	}
+	close( fd[1]);
+
+	// stderr를 모두 읽음
+	size_t len = 0;
+	ssize_t n;
+	while (pid > 0 && (n = read( fd[0], buf + len, sizeof(buf) - 1 - len)) > 0)
+		len += n;
+	buf[len] = '\0';
+	close( fd[0]);
+
+	struct rusage usage;
+	int status;
+	if (pid < 0 || wait4( pid, &status, 0, &usage) < 0 || !WIFEXITED( status) || WEXITSTATUS( status) != 0)
+		return -1;
+	result->seconds = now_sec() - start;
+
+	char *line = strstr( buf, "lines created!");
+	if (line == NULL)
+		return -1;
+	while (line > buf && line[-1] != '\n')
+		line--;
+
+	snprintf( result->engine, sizeof(result->engine), "brute");
+	snprintf( result->distribution, sizeof(result->distribution), "%s", pointgen_names[distribution]);
+	result->num_point = num_point;
+	result->peak_rss = usage.ru_maxrss;
+	result->num_line = atoi( line);
+	return 0;
+}
+
+static void print_bench_result( int format, t_bench_result *r, int first)
+{
+	double rate = (r->seconds > 0) ? r->num_point / r->seconds : 0;
+
+	if (format == BENCH_CSV)
+		printf( "%s,%s,%lld,%.6f,%.0f,%ld,%d\n", r->engine, r->distribution, r->num_point, r->seconds, rate, r->peak_rss, r->num_line);
+	else
+		printf( "%s  {\"engine\": \"%s\", \"distribution\": \"%s\", \"n\": %lld, \"seconds\": %.6f, \"points_per_sec\": %.0f, \"peak_rss_kb\": %ld, \"hull_lines\": %d}",
+			first ? "" : ",\n", r->engine, r->distribution, r->num_point, r->seconds, rate, r->peak_rss, r->num_line);
+	fflush( stdout);
+}
+
+// 기준 CSV(이 함수가 출력한 CSV)와 비교
+// return value : 느려진 결과의 수, 기준 파일을 읽을 수 없으면 -1
+static int compare_baseline( const char *filename, t_bench_result *results, int num_result, double threshold)
+{
+	FILE *fp = fopen( filename, "r");
+	char line[256];
+	int num_slow = 0;
+
+	if (fp == NULL)
+		return -1;
+
+	while (fgets( line, sizeof(line), fp) != NULL)
+	{
+		t_bench_result base;
+		double rate;
+
+		if (sscanf( line, "%31[^,],%15[^,],%lld,%lf,%lf,%ld,%d", base.engine, base.distribution, &base.num_point, &base.seconds, &rate, &base.peak_rss, &base.num_line) != 7)
+			continue; // 헤더
+		if (base.seconds < BENCH_MIN_SECONDS)
+			continue;
+
+		for (int i = 0; i < num_result; i++)
+		{
+			t_bench_result *r = &results[i];
+			if (strcmp( r->engine, base.engine) != 0 || strcmp( r->distribution, base.distribution) != 0 || r->num_point != base.num_point)
+				continue;
+
+			double current = (r->seconds > 0) ? r->num_point / r->seconds : 0;
+			if (current < rate * (1 - threshold / 100))
+			{
+				fprintf( stderr, "regression: %s %s n=%lld %.0f points/s (baseline %.0f)\n", r->engine, r->distribution, r->num_point, current, rate);
+				num_slow++;
+			}
+		}
+	}
+	fclose( fp);
+	return num_slow;
+}
+
+// [input] engine : 이 엔진만 실행 (NULL이면 모든 엔진)
+// [input] brute : brute force 실행 파일의 경로 (NULL이면 실행하지 않음)
+// [input] baseline : 기준 CSV (NULL이면 비교하지 않음)
+// return value : 프로그램의 종료 코드 (느려진 결과가 있으면 1)
+int run_benchmark( int format, int max_point, const t_engine *engine, const t_sorter *sorter, const char *brute, const char *baseline, double threshold, uint64_t seed)
+{
+	int capacity = 64, num_result = 0;
+	t_bench_result *results = (t_bench_result *) malloc( capacity * sizeof(t_bench_result));
+	assert( results != NULL);
+
+	if (format == BENCH_CSV)
+		printf( "engine,distribution,n,seconds,points_per_sec,peak_rss_kb,hull_lines\n");
+	else
+		printf( "[\n");
+
+	for (long long n = BENCH_MIN_POINT; n <= max_point; n *= 10)
+	{
+		for (int d = 0; d < NUM_BENCH_DIST; d++)
+		{
+			// 엔진들 + brute force
+			for (int e = 0; e <= NUM_ENGINE; e++)
+			{
+				const t_engine *en = (e < NUM_ENGINE) ? &engines[e] : NULL;
+				int ok;
+
+				if (num_result == capacity)
+				{
+					capacity *= 2;
+					results = (t_bench_result *) realloc( results, capacity * sizeof(t_bench_result));
+					assert( results != NULL);
+				}
+
+				if (en == NULL)
+				{
+					if (brute == NULL || n > BRUTE_MAX_POINTS)
+						continue;
+					ok = bench_brute( brute, bench_distributions[d], (int) n, seed, &results[num_result]);
+				}
+				else
+				{
+					if (engine != NULL && en != engine)
+						continue;
+					ok = bench_engine( en, sorter, bench_distributions[d], (int) n, seed, &results[num_result]);
+
+					for (int r = 1; ok == 0 && n <= BENCH_REPEAT_POINT && r < BENCH_REPEAT; r++)
+					{
+						t_bench_result again;
+						ok = bench_engine( en, sorter, bench_distributions[d], (int) n, seed, &again);
+						if (ok == 0 && again.seconds < results[num_result].seconds)
+							results[num_result].seconds = again.seconds;
+					}
+				}
+
+				if (ok < 0)
+				{
+					fprintf( stderr, "%s %s n=%lld failed!\n", en ? en->name : "brute", pointgen_names[bench_distributions[d]], n);
+					continue;
+				}
+				print_bench_result( format, &results[num_result], num_result == 0);
+				num_result++;
+			}
+		}
+	}
+
+	if (format == BENCH_JSON)
+		printf( "\n]\n");
+
+	int status = 0;
+	if (baseline != NULL)
+	{
+		int num_slow = compare_baseline( baseline, results, num_result, threshold);
+		if (num_slow < 0)
+		{
+			fprintf( stderr, "%s: cannot read the baseline!\n", baseline);
+			status = 1;
+		}
+		else if (num_slow > 0)
+			status = 1;
+		else
+			fprintf( stderr, "no regression! (threshold %.1f%%)\n", threshold);
+	}
+
+	free( results);
+	return status;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main( int argc, char **argv)
+{
+	int num_point; // number of points
+	
+	uint64_t seed = time( NULL); // 점 생성의 seed (-S)
+	int distribution = POINTGEN_UNIFORM; // 점의 분포 (-g)
+	const t_engine *engine = &engines[0];
+	int engine_given = 0; // -e로 엔진을 지정했는지 (벤치마크는 지정하지 않으면 모든 엔진)
+	const t_sorter *sorter = &sorters[0];
+	int prefilter = 0; // Akl-Toussaint 전처리 (-f)
+	int output = OUTPUT_R; // 출력 형식 (-o)
+	int budget = -1; // 출력할 convex hull 내부 점의 최대 수 (-d), 음수이면 모든 점
+	char *input = NULL; // 점들을 읽을 파일 (-i), "-"이면 stdin
+	int chunk = STREAM_CHUNK; // 한 번에 읽을 점의 수 (-c)
+	int num_query = 0; // 포함 판정을 할 임의의 점의 수 (-q)
+	int bench = -1; // 벤치마크 출력 형식 (-b), 음수이면 벤치마크를 하지 않음
+	char *brute = NULL; // 벤치마크에서 실행할 brute force 실행 파일 (-x)
+	char *baseline = NULL; // 벤치마크의 기준 CSV (-R)
+	double threshold = 10; // 기준보다 느려졌다고 판단하는 비율 (%, -T)
+	int group_size = 0; // 점들을 이 크기의 그룹으로 나누어 그룹마다 convex hull을 구함 (-G)
+	int window = 0; // 마지막 window 개 점의 convex hull을 구함 (-w)
+	int step = 1; // 창의 convex hull을 구하는 간격 (-p)
+	int opt;
+
+	while ((opt = getopt( argc, argv, "e:s:t:fr:o:d:i:c:q:k:S:g:b:x:R:T:G:w:p:")) != -1)
+	{
+		switch (opt)
+		{
+			case 'w':
+				window = atoi( optarg);
+				if (window <= 0)
+				{
+					printf( "The window size should be a positive integer!\n");
+					return 0;
+				}
+				break;
+			case 'p':
+				step = atoi( optarg);
+				if (step <= 0)
+				{
+					printf( "The step should be a positive integer!\n");
+					return 0;
+				}
+				break;
+			case 'G':
+				group_size = atoi( optarg);
+				if (group_size <= 0)
+				{
+					printf( "The group size should be a positive integer!\n");
+					return 0;
+				}
+				break;
+			case 'b':
+				if (strcmp( optarg, "csv") == 0)
+					bench = BENCH_CSV;
+				else if (strcmp( optarg, "json") == 0)
+					bench = BENCH_JSON;
+				else
+				{
+					printf( "Unknown benchmark format: %s\n", optarg);
+					return 0;
+				}
+				break;
+			case 'x':
+				brute = optarg;
+				break;
+			case 'R':
+				baseline = optarg;
+				break;
+			case 'T':
+				threshold = atof( optarg);
+				break;
+			case 'S':
+				seed = strtoull( optarg, NULL, 0);
+				break;
+			case 'g':
+				distribution = find_distribution( optarg);
+				if (distribution < 0)
+				{
+					printf( "Unknown distribution: %s\n", optarg);
+					return 0;
+				}
+				break;
+			case 'k':
+				num_strip = atoi( optarg);
+				if (num_strip <= 0)
+				{
+					printf( "The number of strips should be a positive integer!\n");
+					return 0;
+				}
+				break;
+			case 'e':
+				engine = find_engine( optarg);
+				engine_given = 1;
+				if (engine == NULL)
+				{
+					printf( "Unknown engine: %s\n", optarg);
+					return 0;
+				}
+				break;
+			case 's':
+				sorter = find_sorter( optarg);
+				if (sorter == NULL)
+				{
+					printf( "Unknown sort: %s\n", optarg);
+					return 0;
+				}
+				break;
+			case 't':
+				num_thread = atoi( optarg);
+				if (num_thread < 1 || num_thread > MAX_THREAD)
+				{
+					printf( "The number of threads should be between 1 and %d!\n", MAX_THREAD);
+					return 0;
+				}
+				break;
+			case 'f':
+				prefilter = 1;
+				break;
+			case 'r':
+				range = atoi( optarg);
+				if (range <= 0)
+				{
+					printf( "The range should be a positive integer!\n");
+					return 0;
+				}
+				break;
+			case 'o':
+				output = find_output( optarg);
+				if (output < 0)
+				{
+					printf( "Unknown output format: %s\n", optarg);
+					return 0;
+				}
+				break;
+			case 'd':
+				budget = atoi( optarg);
+				break;
+			case 'i':
+				input = optarg;
+				break;
+			case 'c':
+				chunk = atoi( optarg);
+				if (chunk <= 0)
+				{
+					printf( "The chunk size should be a positive integer!\n");
+					return 0;
+				}
+				break;
+			case 'q':
+				num_query = atoi( optarg);
+				if (num_query < 0)
+				{
+					printf( "The number of queries should be a non-negative integer!\n");
+					return 0;
+				}
+				break;
+			default:
+				print_usage( argv[0]);
+				return 0;
+		}
+	}
+
+	// 파일의 점들로 convex hull을 구하면 convex hull의 꼭짓점들만 출력
+	if (input != NULL)
+	{
+		if (optind != argc)
+		{
+			print_usage( argv[0]);
+			return 0;
+		}
+
+		t_point_reader reader;
+		if (point_reader_open( &reader, input) < 0)
+		{
+			perror( input);
+			return 1;
+		}
+
+		t_point *hull;
+		int num_hull, num_line;
+		long long num_read;
+		t_line *lines = convex_hull_stream( &reader, chunk, engine, sorter, prefilter, &hull, &num_hull, &num_read, &num_line);
+		point_reader_close( &reader);
+
+		fprintf( stderr, "%lld points read!\n", num_read);
+		if (lines == NULL)
+		{
+			printf( "No points in %s!\n", input);
+			free( hull);
+			return 1;
+		}
+		fprintf( stderr, "%d lines created!\n", num_line);
+		if (engine->func == convex_hull_approx)
+			fprintf( stderr, "error bound : %.3f\n", approx_error);
+
+		write_output( output, hull, num_hull, lines, num_line, budget);
+		if (num_query > 0)
+			run_queries( lines, num_line, num_query, seed);
+
+		free( hull);
+		free( lines);
+		return 0;
+	}
+
+	if (optind != argc - 1)
+	{
+		print_usage( argv[0]);
+		return 0;
+	}
+
+	num_point = atoi( argv[optind]);
+	if (num_point <= 0)
+	{
+		printf( "The number of points should be a positive integer!\n");
+		return 0;
+	}
+
+	// number_of_points 까지 n을 10배씩 늘리며 벤치마크
+	if (bench >= 0)
+		return run_benchmark( bench, num_point, engine_given ? engine : NULL, sorter, brute, baseline, threshold, seed);
+
+	t_point *points;
+	points = (t_point *)malloc( sizeof(t_point) * num_point);
+	assert( points != NULL);
+	
+	// making points (1 ~ range, 같은 seed이면 스레드 수와 관계없이 같은 점들)
+	generate_points( points, num_point, distribution, seed, POINTGEN_STREAM_POINT, range, num_thread);
+
+	fprintf( stderr, "%d points created! (seed %llu)\n", num_point, (unsigned long long) seed);
+
+	// 점들을 앞에서부터 group_size 개씩 그룹으로 나누어 그룹마다 convex hull
+	if (group_size > 0)
+	{
+		int num_group = (num_point + group_size - 1) / group_size;
+		int *offset = (int *) malloc( (num_group + 1) * sizeof(int));
+		int *hull_offset = (int *) malloc( (num_group + 1) * sizeof(int));
+		assert( offset != NULL && hull_offset != NULL);
+
+		for (int g = 0; g < num_group; g++)
+			offset[g] = g * group_size;
+		offset[num_group] = num_point;
+
+		double start = now_sec();
+		t_point *hull = convex_hull_batch( points, offset, num_group, hull_offset);
+		double elapsed = now_sec() - start;
+
+		fprintf( stderr, "%d groups, %d hull vertices created! (%.3f sec)\n", num_group, hull_offset[num_group], elapsed);
+
+		free( hull);
+		free( hull_offset);
+		free( offset);
+		free( points);
+		return 0;
+	}
+
+	// 점들을 차례로 창에 넣으며 창이 step 개씩 움직일 때마다 마지막 window 개 점의 convex hull
+	if (window > 0)
+	{
+		t_window_hull w;
+		t_point *hull = NULL;
+		int num_hull = 0, num_window = 0, max_hull = 0;
+		long long sum_hull = 0;
+
+		window_init( &w);
+		double start = now_sec();
+		for (int i = 0; i < num_point; i++)
+		{
+			if (w.size == window)
+				window_pop( &w);
+			window_push( &w, points[i]);
+
+			// 창이 처음 찼을 때부터 step 개마다, 그리고 마지막 점에서
+			if ((i + 1 >= window && (i + 1 - window) % step == 0) || i == num_point - 1)
+			{
+				free( hull);
+				hull = window_hull( &w, &num_hull);
+				num_window++;
+				sum_hull += num_hull;
+				if (num_hull > max_hull)
+					max_hull = num_hull;
+			}
+		}
+		double elapsed = now_sec() - start;
+
+		fprintf( stderr, "%d windows, average %.1f, max %d hull vertices! (%.3f sec)\n",
+			num_window, (double) sum_hull / num_window, max_hull, elapsed);
+
+		// 마지막 창의 convex hull의 꼭짓점들만 출력
+		t_line *lines = (t_line *) malloc( (num_hull + 1) * sizeof(t_line));
+		assert( lines != NULL);
+		int num_line = ring_to_lines( hull, num_hull, lines);
+
+		write_output( output, hull, num_hull, lines, num_line, budget);
+		if (num_query > 0)
+			run_queries( lines, num_line, num_query, seed);
+
+		window_free( &w);
+		free( lines);
+		free( hull);
+		free( points);
+		return 0;
+	}
+	
+	// convex hull의 점이 될 수 없는 점들을 뒤쪽으로 보내고 앞쪽의 num_input 개의 점들로 convex hull을 구함
+	int num_input = num_point;
+	if (prefilter)
+	{
+		num_input = akl_toussaint( points, num_point);
+		fprintf( stderr, "%d points survived the prefilter!\n", num_input);
+	}
+	
+	// sort the points by their x (and y) coordinate
+	sorter->func( points, num_input);
+	
+	// convex hull algorithm
+	int num_line;
+	t_line *lines = engine->func( points, num_input, &num_line);
+	
+	fprintf( stderr, "%d lines created!\n", num_line);
+	if (engine->func == convex_hull_approx)
+		fprintf( stderr, "error bound : %.3f\n", approx_error);
+
+	write_output( output, points, num_point, lines, num_line, budget);
+	if (num_query > 0)
+		run_queries( lines, num_line, num_query, seed);
 	
 	free( points);
 	free( lines);
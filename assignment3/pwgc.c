@@ -1,11 +1,61 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <assert.h>
 
 #define PEASANT 0x08
 #define WOLF	0x04
 #define GOAT	0x02
 #define CABBAGE	0x01
 
+// 비트 집합 (상태 번호마다 한 비트)
+static inline int bit_test( const uint64_t *set, uint64_t i)
+{
+	return (set[i >> 6] >> (i & 63)) & 1;
+}
+
+static inline void bit_set( uint64_t *set, uint64_t i)
+{
+	set[i >> 6] |= (uint64_t) 1 << (i & 63);
+}
+
+static inline void bit_clear( uint64_t *set, uint64_t i)
+{
+	set[i >> 6] &= ~((uint64_t) 1 << (i & 63));
+}
+
+// 비트 집합으로 나타낸 그래프 (인접 행렬의 각 행을 64비트 word들로 저장)
+// 정수 하나에 한 칸을 저장하는 인접 행렬의 1/32 메모리이며, 한 상태의 인접 상태들을 word 단위의 OR로 한꺼번에 더할 수 있음
+typedef struct
+{
+	int num_vertex;
+	int num_word;		// 한 행의 word 수
+	uint64_t *row;		// row + v * num_word : v의 인접 상태들
+} t_bitgraph;
+
+// return value : 0 성공, -1 메모리 부족
+static int bitgraph_init( t_bitgraph *graph, int num_vertex)
+{
+	graph->num_vertex = num_vertex;
+	graph->num_word = (num_vertex + 63) / 64;
+	graph->row = (uint64_t *) calloc( (size_t) num_vertex * graph->num_word, sizeof(uint64_t));
+	return (graph->row == NULL) ? -1 : 0;
+}
+
+static void bitgraph_free( t_bitgraph *graph)
+{
+	free( graph->row);
+}
+
+static inline uint64_t *bitgraph_row( const t_bitgraph *graph, int v)
+{
+	return graph->row + (size_t) v * graph->num_word;
+}
+
 // 주어진 상태 state의 이름(마지막 4비트)을 화면에 출력
 // 예) state가 7(0111)일 때, "<0111>"을 출력
 static void print_statename( FILE *fp, int state);
@@ -41,28 +91,124 @@ static int changePG( int state);
 // return value : 새로운 상태, 상태 변경이 불가능한 경우: -1 
 static int changePC( int state);
 
-// 주어진 state가 이미 방문한 상태인지 검사
+// 주어진 state가 이미 방문한 상태인지 검사 (현재 경로의 상태들은 path_set에 비트로 표시되어 있음)
 // return value : 1 visited, 0 not visited
-static int is_visited( int visited[], int level, int state);
+static int is_visited( const uint64_t *path_set, int state);
 
 // 방문한 상태들을 차례로 화면에 출력
 static void print_states( int visited[], int count);
 
 // recursive function
-static void dfs_main( int state, int goal_state, int level, int visited[]);
+// visited : 현재 경로의 상태들 (출력용), path_set : 같은 상태들의 비트 집합 (검사용)
+static void dfs_main( int state, int goal_state, int level, int visited[], uint64_t *path_set);
 
 ////////////////////////////////////////////////////////////////////////////////
 // 상태들의 인접 행렬을 구하여 graph에 저장
 // 상태간 전이 가능성 점검
 // 허용되지 않는 상태인지 점검 
-void make_adjacency_matrix( int graph[][16]);
+void make_adjacency_matrix( t_bitgraph *graph);
 
 // 인접행렬로 표현된 graph를 화면에 출력
-void print_graph( int graph[][16], int num);
+void print_graph( t_bitgraph *graph);
 
 // 주어진 그래프(graph)를 .net 파일로 저장
 // pgwc.net 참조
-void save_graph( char *filename, int graph[][16], int num);
+void save_graph( char *filename, t_bitgraph *graph);
+
+////////////////////////////////////////////////////////////////////////////////
+// 일반화된 강 건너기 퍼즐
+// 개체들, 함께 남겨둘 수 없는 개체들(conflict), 배에 탈 수 있는 수(capacity)를 파일에서 읽는다. (pwgc.puzzle 참조)
+// 상태는 개체마다 한 비트 (0 : 처음 강가, 1 : 반대편 강가)인 mask로, pwgc의 상태 번호와 같은 방식
+// 배를 젓는 개체(mover, 농부)가 자기 쪽 강가의 개체들 중 capacity - 1 개 이하를 골라 함께 건너므로
+// 다음 상태들은 그 부분집합들을 나열하여 바로 만든다.
+#define MAX_ENTITY		64	// t_state의 비트 수
+#define MAX_CONFLICT	256
+#define NAME_LEN		32
+#define MAX_SEARCH_ENTITY	32	// 탐색은 상태 번호(mask)를 index로 쓰므로 2^32 개의 상태까지
+#define BITGRAPH_MAX_ENTITY	24	// puzzle_bitbfs : 상태 번호 -> vertex 번호 표의 크기
+#define BITGRAPH_MAX_VERTEX	(1 << 16)	// puzzle_bitbfs : 인접 행렬 512MB
+#define CSR_MAX_ENTITY		28	// CSR의 offset 배열 2GB
+#define CSR_MAX_EDGE		((uint64_t) 1 << 30)	// CSR의 target 배열 4GB
+#define CSR_BLOCK			4096	// 스레드가 한 번에 가져가는 상태의 수
+#define MAX_THREAD			256
+
+typedef uint64_t t_state;
+typedef uint32_t t_index;	// 탐색하는 상태의 번호 (MAX_SEARCH_ENTITY 비트)
+
+typedef struct
+{
+	int num_entity;
+	char name[MAX_ENTITY][NAME_LEN];	// name[i] : 비트 i의 개체
+	t_state mover;						// 배를 젓는 개체의 비트
+	int capacity;						// 배에 탈 수 있는 개체의 수 (mover 포함)
+	int num_conflict;
+	t_state conflict[MAX_CONFLICT];		// mover 없이 한 강가에 모두 있으면 안 되는 개체들
+	t_state all;						// 모든 개체의 비트
+	int max_move;						// 한 상태에서 가능한 이동의 최대 수
+} t_puzzle;
+
+// 퍼즐 파일을 읽음
+// return value : 0 성공, -1 실패 (stderr에 이유 출력)
+static int puzzle_load( t_puzzle *puzzle, const char *filename);
+
+// 농부, 늑대, 염소, 양배추 퍼즐 (pwgc.puzzle과 같음, 상태 번호는 PEASANT, WOLF, GOAT, CABBAGE 비트로 pwgc와 같음)
+static void puzzle_pwgc( t_puzzle *puzzle);
+
+// mover가 없는 강가에 conflict의 개체들이 모두 있는지 검사
+// return value: 1 허용되지 않는 상태인 경우, 0 허용되는 상태인 경우
+static int puzzle_is_dead_end( const t_puzzle *puzzle, t_state state);
+
+// state에서 한 번 건너 갈 수 있는 (허용되는) 상태들
+// [output] next : puzzle->max_move 개의 공간이 있어야 함
+// return value : 다음 상태의 수
+static int puzzle_successors( const t_puzzle *puzzle, t_state state, t_state *next);
+
+// 상태를 pwgc와 같이 "<0111>" (가장 높은 비트의 개체부터) 형식으로 출력
+static void puzzle_print_state( FILE *fp, const t_puzzle *puzzle, t_state state);
+
+// 탐색할 상태 그래프 (상태 번호가 vertex 번호, 허용되지 않는 상태에서 나가는 간선은 없음)
+// 모든 상태의 다음 상태들을 한 번씩만 생성하여 CSR(compressed sparse row)로 저장 : O(상태 수 x 이동의 수)
+// offset[s] ~ offset[s+1]-1 번째 target이 s의 다음 상태들
+// CSR이 너무 크면 (offset == NULL) 탐색할 때마다 다음 상태들을 생성
+typedef struct
+{
+	const t_puzzle *puzzle;
+	t_state num_vertex;
+	uint64_t num_edge;
+	uint64_t *offset;
+	t_index *target;
+	t_state *tmp;		// CSR이 없을 때 : puzzle_successors의 출력
+	t_index *buf;		// CSR이 없을 때 : graph_next의 출력
+} t_graph;
+
+// 상태들을 CSR_BLOCK 개씩 num_thread 개의 스레드로 나누어 다음 상태의 수를 세고 (offset), 누적 합을 구한 뒤 다시 나누어 target을 채움
+// return value : 1 CSR을 만든 경우, 0 너무 커서 CSR 없이 탐색하는 경우
+static int graph_build( t_graph *graph, const t_puzzle *puzzle, int num_thread);
+
+static void graph_free( t_graph *graph);
+
+// 초기 상태(0)에서 갈 수 있는 상태들을 깊이 우선으로 모두 방문
+// [output] found : 목적 상태(모두 반대편)에 도달하면 1
+// return value : 방문한 상태의 수
+static long long puzzle_reach( t_graph *graph, int *found);
+
+// 초기 상태(0)에서 목적 상태(puzzle->all)까지 가장 적게 건너는 방법을 너비 우선 탐색으로 찾음
+// 상태마다 처음 발견한 상태(parent)를 저장하여 목적 상태에서 거꾸로 따라감
+// [output] num_visited : 방문한 상태의 수
+// [output] length : 경로의 상태 수 (건너는 횟수 + 1)
+// return value : 초기 상태부터 목적 상태까지의 상태들, 목적 상태에 갈 수 없으면 NULL
+static t_state *puzzle_bfs( t_graph *graph, long long *num_visited, int *length);
+
+// 양방향 너비 우선 탐색 (초기 상태와 목적 상태에서 동시에 시작하여 가운데에서 만남)
+// 건너기는 되돌릴 수 있으므로 목적 상태 쪽도 같은 다음 상태들을 사용
+// 결과는 puzzle_bfs와 같은 길이의 (가장 짧은) 경로
+static t_state *puzzle_bibfs( t_graph *graph, long long *num_visited, int *length);
+
+// 허용되는 상태들의 그래프를 비트 집합 인접 행렬로 만들어 한 층씩 너비 우선 탐색
+// 다음 층은 현재 층의 상태들(ctz로 찾음)의 인접 행을 word 단위로 OR 하여 구하고 방문한 상태들을 지움
+// 상태 수의 제곱 비트의 메모리가 필요하므로 허용되는 상태가 BITGRAPH_MAX_VERTEX 개 이하인 퍼즐만
+// 결과는 puzzle_bfs와 같은 길이의 (가장 짧은) 경로, 상태가 너무 많으면 *length가 -1
+static t_state *puzzle_bitbfs( t_graph *graph, long long *num_visited, int *length);
 
 ////////////////////////////////////////////////////////////////////////////////
 // 깊이 우선 탐색 (초기 상태 -> 목적 상태)
@@ -70,23 +216,145 @@ void depth_first_search( int init_state, int goal_state)
 {
 	int level = 0;
 	int visited[16] = {0,}; // 방문한 정점을 저장
+	uint64_t path_set[1] = {0,}; // 16개 상태의 비트 집합
 	
-	dfs_main( init_state, goal_state, level, visited); 
+	dfs_main( init_state, goal_state, level, visited, path_set); 
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void print_usage( char *program)
+{
+	printf( "%s [-f puzzle_file] [-m reach|bfs|bibfs|bitbfs] [-t number_of_threads]\n", program);
 }
 
+#define MODE_REACH	0
+#define MODE_BFS	1
+#define MODE_BIBFS	2
+#define MODE_BITBFS	3
+
+static const char *mode_names[] = { "reach", "bfs", "bibfs", "bitbfs"};
+
+#define NUM_MODE (int)(sizeof(mode_names) / sizeof(mode_names[0]))
+
 ////////////////////////////////////////////////////////////////////////////////
 int main( int argc, char **argv)
 {
-	int graph[16][16] = {0,};
+	char *puzzle_file = NULL; // 일반화된 퍼즐 (-f), 없으면 농부, 늑대, 염소, 양배추
+	int mode = MODE_BFS; // 일반화된 퍼즐의 탐색 방법 (-m)
+	int mode_given = 0; // -f 없이 -m만 주면 농부, 늑대, 염소, 양배추 퍼즐을 같은 방법으로 탐색
+	int num_thread = 1; // 그래프를 만들 스레드의 수 (-t)
+	int opt;
+
+	while ((opt = getopt( argc, argv, "f:m:t:")) != -1)
+	{
+		switch (opt)
+		{
+			case 't':
+				num_thread = atoi( optarg);
+				if (num_thread < 1 || num_thread > MAX_THREAD)
+				{
+					printf( "The number of threads should be between 1 and %d!\n", MAX_THREAD);
+					return 0;
+				}
+				break;
+			case 'f':
+				puzzle_file = optarg;
+				break;
+			case 'm':
+				for (mode = 0; mode < NUM_MODE; mode++)
+					if (strcmp( mode_names[mode], optarg) == 0)
+						break;
+				if (mode == NUM_MODE)
+				{
+					printf( "Unknown search mode: %s\n", optarg);
+					return 0;
+				}
+				mode_given = 1;
+				break;
+			default:
+				print_usage( argv[0]);
+				return 0;
+		}
+	}
+
+	if (puzzle_file != NULL || mode_given)
+	{
+		t_puzzle puzzle;
+		int found;
+
+		if (puzzle_file == NULL)
+			puzzle_pwgc( &puzzle);
+		else if (puzzle_load( &puzzle, puzzle_file) < 0)
+			return 1;
+		if (puzzle.num_entity > MAX_SEARCH_ENTITY)
+		{
+			printf( "Too many entities to search: %d (max %d)\n", puzzle.num_entity, MAX_SEARCH_ENTITY);
+			return 1;
+		}
+
+		printf( "%d entities, %d conflicts, capacity %d, up to %d moves per crossing\n",
+			puzzle.num_entity, puzzle.num_conflict, puzzle.capacity, puzzle.max_move);
+
+		t_graph graph;
+		if (graph_build( &graph, &puzzle, num_thread))
+			printf( "%llu transitions\n", (unsigned long long) graph.num_edge);
+		else
+			printf( "Too many states or transitions for CSR, generating them during the search\n");
+
+		if (mode == MODE_REACH)
+		{
+			long long num_visited = puzzle_reach( &graph, &found);
+			printf( "%lld states reachable, goal-state %s\n", num_visited, found ? "found!" : "not reachable");
+			graph_free( &graph);
+			return 0;
+		}
+
+		long long num_visited;
+		int length;
+		t_state *path;
+
+		if (mode == MODE_BFS)
+			path = puzzle_bfs( &graph, &num_visited, &length);
+		else if (mode == MODE_BIBFS)
+			path = puzzle_bibfs( &graph, &num_visited, &length);
+		else
+		{
+			path = puzzle_bitbfs( &graph, &num_visited, &length);
+			if (length < 0)
+			{
+				printf( "Too many states for bitbfs (max %d allowed states)\n", BITGRAPH_MAX_VERTEX);
+				graph_free( &graph);
+				return 1;
+			}
+		}
+		graph_free( &graph);
+
+		printf( "%lld states visited\n", num_visited);
+		if (path == NULL)
+		{
+			printf( "Goal-state not reachable!\n");
+			return 0;
+		}
+
+		printf( "\nGoal-state found! (%d crossings)\n", length - 1);
+		for (int i = 0; i < length; i++)
+			puzzle_print_state( stdout, &puzzle, path[i]);
+		free( path);
+		return 0;
+	}
+
+	t_bitgraph graph;
+	bitgraph_init( &graph, 16);
 	
 	// 인접 행렬 만들기
-	make_adjacency_matrix( graph);
+	make_adjacency_matrix( &graph);
 
 	// 인접 행렬 출력 (only for debugging)
-	print_graph( graph, 16);
+	print_graph( &graph);
 	
 	// .net 파일 만들기
-	save_graph( "pwgc.net", graph, 16);
+	save_graph( "pwgc.net", &graph);
+	bitgraph_free( &graph);
 
 	// 깊이 우선 탐색
 	depth_first_search( 0, 15); // initial state, goal state
@@ -191,12 +459,8 @@ static int changePC( int state){
 
 // 주어진 state가 이미 방문한 상태인지 검사
 // return value : 1 visited, 0 not visited
-static int is_visited( int visited[], int level, int state){
-	for(int i = 0; i<level; i++){
-		if(state == visited[i])
-			return 1;
-	}
-	return 0;
+static int is_visited( const uint64_t *path_set, int state){
+	return bit_test(path_set, state);
 }
 
 // 방문한 상태들을 차례로 화면에 출력
@@ -209,7 +473,7 @@ static void print_states( int visited[], int count){
 }
 
 // recursive function
-static void dfs_main( int state, int goal_state, int level, int visited[]){
+static void dfs_main( int state, int goal_state, int level, int visited[], uint64_t *path_set){
 	int p=0, w=0, g=0, c=0;
 	get_pwgc(state, &p,&w,&g,&c);
 	visited[level] = state;
@@ -220,6 +484,7 @@ static void dfs_main( int state, int goal_state, int level, int visited[]){
 		 return;
 	}
 	else{
+		bit_set(path_set, state);
 		int pstate = changeP(state);
 		int pwstate = changePW(state);
 		int pcstate = changePC(state);
@@ -227,11 +492,11 @@ static void dfs_main( int state, int goal_state, int level, int visited[]){
 		
 		get_pwgc(pstate, &p,&w,&g,&c); 
 		if(is_possible_transition(state, pstate)){
-			if(is_visited(visited,level, pstate)){
+			if(is_visited(path_set, pstate)){
 				printf("\tnext state <%d%d%d%d> has been visited\n", p,w,g,c);
 			}
 			else{
-				dfs_main(pstate, goal_state, level+1, visited);		
+				dfs_main(pstate, goal_state, level+1, visited, path_set);		
 				get_pwgc(state, &p,&w,&g,&c); 
 				printf("back to <%d%d%d%d> (level %d)\n" ,p,w,g,c, level);
 			}
@@ -243,11 +508,11 @@ static void dfs_main( int state, int goal_state, int level, int visited[]){
 
 		get_pwgc(pwstate, &p,&w,&g,&c); 
 		if(pwstate != -1){
-			if(is_visited(visited, level, pwstate)){
+			if(is_visited(path_set, pwstate)){
 				printf("\tnext state <%d%d%d%d> has been visited\n", p,w,g,c);
 			}
 			else{
-				dfs_main(pwstate, goal_state, level+1, visited);		
+				dfs_main(pwstate, goal_state, level+1, visited, path_set);		
 				get_pwgc(state, &p,&w,&g,&c); 
 				printf("back to <%d%d%d%d> (level %d)\n", p,w,g,c, level);
 			}
@@ -259,11 +524,11 @@ static void dfs_main( int state, int goal_state, int level, int visited[]){
 
 		get_pwgc(pgstate, &p,&w,&g,&c); 
 		if(pgstate != -1){
-			if(is_visited(visited,level, pgstate)){
+			if(is_visited(path_set, pgstate)){
 				printf("\tnext state <%d%d%d%d> has been visited\n", p,w,g,c);
 			}
 			else{
-				dfs_main(pgstate, goal_state, level+1, visited);		
+				dfs_main(pgstate, goal_state, level+1, visited, path_set);		
 				get_pwgc(state, &p,&w,&g,&c); 
 				printf("back to <%d%d%d%d> (level %d)\n", p,w,g,c, level);
 			}
@@ -276,11 +541,11 @@ static void dfs_main( int state, int goal_state, int level, int visited[]){
 		
 		get_pwgc(pcstate, &p,&w,&g,&c); 
 		if(pcstate != -1){
-			if(is_visited(visited,level, pcstate)){
+			if(is_visited(path_set, pcstate)){
 				printf("\tnext state <%d%d%d%d> has been visited\n", p,w,g,c);
 			}
 			else{
-				dfs_main(pcstate, goal_state, level+1, visited);		
+				dfs_main(pcstate, goal_state, level+1, visited, path_set);		
 				get_pwgc(state, &p,&w,&g,&c); 
 				printf("back to <%d%d%d%d> (level %d)\n", p,w,g,c, level);
 			}
@@ -288,6 +553,7 @@ static void dfs_main( int state, int goal_state, int level, int visited[]){
 		else {
 			printf("\tnext state <%d%d%d%d> is dead-end\n",(state & PEASANT) ? 0: 1, (state & WOLF) >> 2, (state & GOAT) >> 1, (state & CABBAGE)?0:1);
 		}
+		bit_clear(path_set, state);
 	}
 }
 
@@ -295,24 +561,35 @@ static void dfs_main( int state, int goal_state, int level, int visited[]){
 // 상태들의 인접 행렬을 구하여 graph에 저장
 // 상태간 전이 가능성 점검
 // 허용되지 않는 상태인지 점검 
-void make_adjacency_matrix( int graph[][16]){
-	int i, j;
+// 모든 상태 쌍을 검사하지 않고 상태마다 가능한 이동(농부 혼자, 농부와 늑대/염소/양배추)으로 다음 상태들을 바로 만듦
+void make_adjacency_matrix( t_bitgraph *graph){
+	int i, k;
 	for(i=0;i<16;i++){
-		for(j=0;j<16;j++){
-			if(is_dead_end(i) == 0 && is_possible_transition(i,j))
-				graph[i][j] = 1;
-			else
-				graph[i][j] = 0;
+		uint64_t *row = bitgraph_row(graph, i);
+		for(k=0;k<graph->num_word;k++)
+			row[k] = 0;
+		if(is_dead_end(i))
+			continue;
+
+		int pstate = changeP(i);
+		if(is_possible_transition(i, pstate))
+			bit_set(row, pstate);
+
+		int next[3] = { changePW(i), changePG(i), changePC(i)};
+		for(k=0;k<3;k++){
+			if(next[k] != -1)
+				bit_set(row, next[k]);
 		}
 	}
 }
 
 // 인접행렬로 표현된 graph를 화면에 출력
-void print_graph( int graph[][16], int num){
+void print_graph( t_bitgraph *graph){
 	int i, j;
-	for(i=0;i<16; i++){
-		for(j=0;j<16;j++){
-			printf("%d ", graph[i][j]);
+	for(i=0;i<graph->num_vertex; i++){
+		uint64_t *row = bitgraph_row(graph, i);
+		for(j=0;j<graph->num_vertex;j++){
+			printf("%d ", bit_test(row, j));
 		}
 		printf("\n");
 	}
@@ -320,9 +597,10 @@ void print_graph( int graph[][16], int num){
 
 // 주어진 그래프(graph)를 .net 파일로 저장
 // pgwc.net 참조
-void save_graph( char *filename, int graph[][16], int num){
+void save_graph( char *filename, t_bitgraph *graph){
+	int num = graph->num_vertex;
 	FILE *file = fopen(filename, "w");
-    fprintf(file, "*Vertices 16\n");
+    fprintf(file, "*Vertices %d\n", num);
     for(int i = 1; i <= num; i++){
         fprintf(file, "%d ", i);
         print_statename(file, i - 1);
@@ -330,9 +608,705 @@ void save_graph( char *filename, int graph[][16], int num){
     fprintf(file, "*Edges\n");
     for(int i = 0; i < num; i++){
         for(int j = i + 1; j < num; j++){
-            if(graph[i][j]) fprintf(file, "%3d%3d\n", i + 1, j + 1);
+            if(bit_test(bitgraph_row(graph, i), j)) fprintf(file, "%3d%3d\n", i + 1, j + 1);
         }
     }
     fclose(file);
 }
 
+
+////////////////////////////////////////////////////////////////////////////////
+// 이름으로 개체를 찾음
+// return value : 비트 번호, 없으면 -1
+static int find_entity( const t_puzzle *puzzle, const char *name)
+{
+	for (int i = 0; i < puzzle->num_entity; i++)
+		if (strcmp( puzzle->name[i], name) == 0)
+			return i;
+	return -1;
+}
+
+// 퍼즐 파일의 형식 (한 줄에 하나, '#' 뒤는 주석)
+//   entity <name> [mover]     : 개체 (처음 나온 것부터 비트 0, 1, ...), mover는 하나만
+//   capacity <k>              : 배에 탈 수 있는 개체의 수 (mover 포함)
+//   conflict <name> <name>... : mover 없이 함께 남겨둘 수 없는 개체들
+static int puzzle_load( t_puzzle *puzzle, const char *filename)
+{
+	FILE *fp = fopen( filename, "r");
+	char line[1024];
+	int line_no = 0;
+
+	if (fp == NULL)
+	{
+		perror( filename);
+		return -1;
+	}
+
+	memset( puzzle, 0, sizeof(t_puzzle));
+	puzzle->capacity = 2;
+
+	while (fgets( line, sizeof(line), fp) != NULL)
+	{
+		char *comment = strchr( line, '#');
+		char *token;
+
+		line_no++;
+		if (comment != NULL)
+			*comment = '\0';
+		if ((token = strtok( line, " \t\r\n")) == NULL)
+			continue;
+
+		if (strcmp( token, "entity") == 0)
+		{
+			char *name = strtok( NULL, " \t\r\n");
+			char *flag = strtok( NULL, " \t\r\n");
+
+			if (name == NULL || strlen( name) >= NAME_LEN || find_entity( puzzle, name) >= 0 || puzzle->num_entity == MAX_ENTITY)
+				goto error;
+
+			int bit = puzzle->num_entity++;
+			strcpy( puzzle->name[bit], name);
+			puzzle->all |= (t_state) 1 << bit;
+
+			if (flag != NULL)
+			{
+				if (strcmp( flag, "mover") != 0 || puzzle->mover != 0)
+					goto error;
+				puzzle->mover = (t_state) 1 << bit;
+			}
+		}
+		else if (strcmp( token, "capacity") == 0)
+		{
+			token = strtok( NULL, " \t\r\n");
+			if (token == NULL || (puzzle->capacity = atoi( token)) < 1)
+				goto error;
+		}
+		else if (strcmp( token, "conflict") == 0)
+		{
+			t_state c = 0;
+			int bit;
+
+			while ((token = strtok( NULL, " \t\r\n")) != NULL)
+			{
+				if ((bit = find_entity( puzzle, token)) < 0)
+					goto error;
+				c |= (t_state) 1 << bit;
+			}
+			if (c == 0 || (c & puzzle->mover) || puzzle->num_conflict == MAX_CONFLICT)
+				goto error;
+			puzzle->conflict[puzzle->num_conflict++] = c;
+		}
+		else
+			goto error;
+	}
+	fclose( fp);
+
+	if (puzzle->mover == 0)
+	{
+		fprintf( stderr, "%s: no mover entity\n", filename);
+		return -1;
+	}
+
+	// 이동의 수 : sum C(num_entity - 1, j), j = 0 ~ capacity - 1
+	long long num_move = 0, comb = 1;
+	for (int j = 0; j < puzzle->capacity && j < puzzle->num_entity; j++)
+	{
+		num_move += comb;
+		comb = comb * (puzzle->num_entity - 1 - j) / (j + 1);
+		if (num_move > (1 << 20))
+		{
+			fprintf( stderr, "%s: too many moves per crossing\n", filename);
+			return -1;
+		}
+	}
+	puzzle->max_move = (int) num_move;
+	return 0;
+
+error:
+	fprintf( stderr, "%s:%d: invalid line\n", filename, line_no);
+	fclose( fp);
+	return -1;
+}
+
+static void puzzle_pwgc( t_puzzle *puzzle)
+{
+	static const char *names[] = { "cabbage", "goat", "wolf", "peasant"}; // 비트 0 ~ 3
+
+	memset( puzzle, 0, sizeof(t_puzzle));
+	puzzle->num_entity = 4;
+	for (int i = 0; i < puzzle->num_entity; i++)
+		strcpy( puzzle->name[i], names[i]);
+	puzzle->mover = PEASANT;
+	puzzle->capacity = 2;
+	puzzle->conflict[puzzle->num_conflict++] = WOLF | GOAT;
+	puzzle->conflict[puzzle->num_conflict++] = GOAT | CABBAGE;
+	puzzle->all = PEASANT | WOLF | GOAT | CABBAGE;
+	puzzle->max_move = 4; // 농부 혼자, 또는 늑대, 염소, 양배추 중 하나와 함께
+}
+
+static int puzzle_is_dead_end( const t_puzzle *puzzle, t_state state)
+{
+	// mover가 없는 강가의 개체들
+	t_state alone = (state & puzzle->mover) ? (~state & puzzle->all) : state;
+
+	for (int i = 0; i < puzzle->num_conflict; i++)
+		if ((alone & puzzle->conflict[i]) == puzzle->conflict[i])
+			return 1;
+	return 0;
+}
+
+// mover와 cargo에 avail 중 left 개 이하를 더 태워 건넌 상태들을 next[n]부터 씀
+// 같은 부분집합을 두 번 만들지 않도록 cargo에 넣은 비트보다 높은 비트들만 avail로 넘김
+// return value : 다음에 쓸 위치
+static int add_moves( const t_puzzle *puzzle, t_state state, t_state avail, t_state cargo, int left, t_state *next, int n)
+{
+	t_state s = state ^ puzzle->mover ^ cargo;
+
+	if (!puzzle_is_dead_end( puzzle, s))
+		next[n++] = s;
+	if (left == 0)
+		return n;
+
+	while (avail)
+	{
+		t_state bit = avail & -avail;
+
+		avail ^= bit;
+		n = add_moves( puzzle, state, avail, cargo | bit, left - 1, next, n);
+	}
+	return n;
+}
+
+static int puzzle_successors( const t_puzzle *puzzle, t_state state, t_state *next)
+{
+	// mover 쪽 강가의 (mover 외의) 개체들
+	t_state side = (state & puzzle->mover) ? state : (~state & puzzle->all);
+
+	return add_moves( puzzle, state, side & ~puzzle->mover, 0, puzzle->capacity - 1, next, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 상태 그래프 (CSR)
+
+static void *search_alloc( size_t count, size_t size)
+{
+	void *p = calloc( count, size);
+
+	if (p == NULL)
+	{
+		fprintf( stderr, "Not enough memory for %zu states\n", count);
+		exit( 1);
+	}
+	return p;
+}
+
+typedef struct
+{
+	t_graph *graph;
+	atomic_ullong next_block;	// 다음에 처리할 상태
+	int fill;					// 0 : 다음 상태의 수를 offset[s+1]에, 1 : target을 채움
+} t_build;
+
+static void *build_job( void *arg)
+{
+	t_build *build = (t_build *) arg;
+	t_graph *graph = build->graph;
+	const t_puzzle *puzzle = graph->puzzle;
+	t_state *next = (t_state *) malloc( puzzle->max_move * sizeof(t_state));
+	t_state lo;
+
+	assert( next != NULL);
+	while ((lo = atomic_fetch_add( &build->next_block, CSR_BLOCK)) < graph->num_vertex)
+	{
+		t_state hi = (lo + CSR_BLOCK < graph->num_vertex) ? lo + CSR_BLOCK : graph->num_vertex;
+
+		for (t_state s = lo; s < hi; s++)
+		{
+			// 허용되지 않는 상태에서는 나가지 않음
+			int n = puzzle_is_dead_end( puzzle, s) ? 0 : puzzle_successors( puzzle, s, next);
+
+			if (!build->fill)
+				graph->offset[s+1] = n;
+			else
+			{
+				t_index *target = graph->target + graph->offset[s];
+				for (int i = 0; i < n; i++)
+					target[i] = (t_index) next[i];
+			}
+		}
+	}
+	free( next);
+	return NULL;
+}
+
+// 상태들을 num_thread 개의 스레드가 CSR_BLOCK 개씩 가져가며 처리
+static void run_build( t_graph *graph, int fill, int num_thread)
+{
+	pthread_t threads[MAX_THREAD];
+	t_build build = { graph, 0, fill};
+
+	for (int t = 1; t < num_thread; t++)
+		pthread_create( &threads[t], NULL, build_job, &build);
+	build_job( &build);
+	for (int t = 1; t < num_thread; t++)
+		pthread_join( threads[t], NULL);
+}
+
+static int graph_build( t_graph *graph, const t_puzzle *puzzle, int num_thread)
+{
+	graph->puzzle = puzzle;
+	graph->num_vertex = (t_state) 1 << puzzle->num_entity;
+	graph->num_edge = 0;
+	graph->offset = NULL;
+	graph->target = NULL;
+	graph->tmp = (t_state *) search_alloc( puzzle->max_move, sizeof(t_state));
+	graph->buf = (t_index *) search_alloc( puzzle->max_move, sizeof(t_index));
+
+	if (puzzle->num_entity > CSR_MAX_ENTITY)
+		return 0;
+	if ((graph->offset = (uint64_t *) malloc( (graph->num_vertex + 1) * sizeof(uint64_t))) == NULL)
+		return 0;
+
+	run_build( graph, 0, num_thread);
+
+	graph->offset[0] = 0;
+	for (t_state s = 0; s < graph->num_vertex; s++)
+		graph->offset[s+1] += graph->offset[s];
+	graph->num_edge = graph->offset[graph->num_vertex];
+
+	if (graph->num_edge > CSR_MAX_EDGE
+		|| (graph->target = (t_index *) malloc( (graph->num_edge + 1) * sizeof(t_index))) == NULL)
+	{
+		free( graph->offset);
+		graph->offset = NULL;
+		return 0;
+	}
+
+	run_build( graph, 1, num_thread);
+	return 1;
+}
+
+static void graph_free( t_graph *graph)
+{
+	free( graph->offset);
+	free( graph->target);
+	free( graph->tmp);
+	free( graph->buf);
+}
+
+// state의 다음 상태들
+// [output] next : 다음 상태들 (다음 graph_next를 부를 때까지 유효)
+// return value : 다음 상태의 수
+static inline int graph_next( t_graph *graph, t_index state, const t_index **next)
+{
+	if (graph->offset != NULL)
+	{
+		*next = graph->target + graph->offset[state];
+		return (int)(graph->offset[state+1] - graph->offset[state]);
+	}
+
+	int n = puzzle_successors( graph->puzzle, state, graph->tmp);
+	for (int i = 0; i < n; i++)
+		graph->buf[i] = (t_index) graph->tmp[i];
+	*next = graph->buf;
+	return n;
+}
+
+// 재귀 대신 스택을 사용 (상태는 스택에 넣을 때 방문 표시하므로 스택의 크기는 상태의 수 이하)
+static long long puzzle_reach( t_graph *graph, int *found)
+{
+	const t_puzzle *puzzle = graph->puzzle;
+	t_state num_state = graph->num_vertex;
+	uint64_t *visited = (uint64_t *) calloc( (num_state + 63) / 64, sizeof(uint64_t));
+	const t_index *next;
+	long long capacity = 1024, top = 0, count = 0;
+	t_state *stack = (t_state *) malloc( capacity * sizeof(t_state));
+
+	if (visited == NULL || stack == NULL)
+	{
+		fprintf( stderr, "Not enough memory for %llu states\n", (unsigned long long) num_state);
+		exit( 1);
+	}
+
+	*found = 0;
+	bit_set( visited, 0);
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		t_state state = stack[--top];
+
+		count++;
+		if (state == puzzle->all)
+			*found = 1;
+
+		int n = graph_next( graph, state, &next);
+		for (int i = 0; i < n; i++)
+		{
+			if (bit_test( visited, next[i]))
+				continue;
+			bit_set( visited, next[i]);
+
+			if (top == capacity)
+			{
+				capacity *= 2;
+				stack = (t_state *) realloc( stack, capacity * sizeof(t_state));
+				if (stack == NULL)
+				{
+					fprintf( stderr, "Not enough memory for the stack\n");
+					exit( 1);
+				}
+			}
+			stack[top++] = next[i];
+		}
+	}
+
+	free( stack);
+	free( visited);
+	return count;
+}
+
+static void puzzle_print_state( FILE *fp, const t_puzzle *puzzle, t_state state)
+{
+	fprintf( fp, "<");
+	for (int i = puzzle->num_entity - 1; i >= 0; i--)
+		fprintf( fp, "%d", (int)((state >> i) & 1));
+	fprintf( fp, ">\n");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 가장 짧은 경로 탐색
+// 상태 번호는 MAX_SEARCH_ENTITY 비트 이하이므로 parent와 queue는 32비트로 저장 (상태당 4바이트 + 방문 표시 1비트)
+
+// 늘어나는 배열
+typedef struct
+{
+	t_index *item;
+	long long size;
+	long long capacity;
+} t_list;
+
+static void list_push( t_list *list, t_index v)
+{
+	if (list->size == list->capacity)
+	{
+		list->capacity = (list->capacity == 0) ? 1024 : list->capacity * 2;
+		list->item = (t_index *) realloc( list->item, list->capacity * sizeof(t_index));
+		if (list->item == NULL)
+		{
+			fprintf( stderr, "Not enough memory for the search queue\n");
+			exit( 1);
+		}
+	}
+	list->item[list->size++] = v;
+}
+
+// from에서 parent를 따라 root까지의 상태 수
+static int path_length( const t_index *parent, t_index from, t_index root)
+{
+	int n = 1;
+
+	for (t_index s = from; s != root; s = parent[s])
+		n++;
+	return n;
+}
+
+// from에서 parent를 따라 n 개의 상태들을 path[0]부터 (reverse이면 path[n-1]부터 거꾸로) 씀
+static void trace_path( const t_index *parent, t_index from, t_state *path, int n, int reverse)
+{
+	t_index s = from;
+
+	for (int i = 0; i < n; i++, s = parent[s])
+		path[reverse ? n - 1 - i : i] = s;
+}
+
+static t_state *puzzle_bfs( t_graph *graph, long long *num_visited, int *length)
+{
+	t_state num_state = graph->num_vertex;
+	t_index goal = (t_index) graph->puzzle->all;
+	t_index *parent = (t_index *) search_alloc( num_state, sizeof(t_index));
+	uint64_t *visited = (uint64_t *) search_alloc( (num_state + 63) / 64, sizeof(uint64_t));
+	const t_index *next;
+	t_list queue = { NULL, 0, 0};
+	long long head = 0;
+	int found = (goal == 0);
+
+	bit_set( visited, 0);
+	list_push( &queue, 0);
+
+	while (!found && head < queue.size)
+	{
+		t_index state = queue.item[head++];
+		int n = graph_next( graph, state, &next);
+
+		for (int i = 0; i < n; i++)
+		{
+			if (bit_test( visited, next[i]))
+				continue;
+			bit_set( visited, next[i]);
+			parent[next[i]] = state;
+			list_push( &queue, (t_index) next[i]);
+
+			if (next[i] == goal)
+			{
+				found = 1;
+				break;
+			}
+		}
+	}
+
+	t_state *path = NULL;
+	*num_visited = queue.size;
+	*length = 0;
+	if (found)
+	{
+		*length = path_length( parent, goal, 0);
+		path = (t_state *) malloc( *length * sizeof(t_state));
+		trace_path( parent, goal, path, *length, 1);
+	}
+
+	free( queue.item);
+	free( visited);
+	free( parent);
+	return path;
+}
+
+// 두 방향의 탐색이 모두 한 층(level)씩 번갈아 진행하며, 다음 층의 상태 수가 적을 것 같은 (현재 층이 작은) 쪽을 넓힘
+// 한 쪽이 새로 발견한 상태가 다른 쪽에서 이미 방문한 상태이면 그 상태에서 만남
+// (그 전까지 두 쪽의 방문 상태가 겹치지 않았으므로 처음 만난 경로가 가장 짧음)
+static t_state *puzzle_bibfs( t_graph *graph, long long *num_visited, int *length)
+{
+	t_state num_state = graph->num_vertex;
+	t_index root[2] = { 0, (t_index) graph->puzzle->all};
+	t_index *parent = (t_index *) search_alloc( num_state, sizeof(t_index)); // 각 쪽의 root 방향
+	uint64_t *visited[2];
+	t_list frontier[2] = { { NULL, 0, 0}, { NULL, 0, 0}};
+	t_list level = { NULL, 0, 0};
+	const t_index *next;
+	t_index meet = 0, meet_parent = 0; // meet_parent에서 meet을 발견 (meet은 다른 쪽에서 방문한 상태)
+	int meet_side = -1;
+
+	for (int side = 0; side < 2; side++)
+	{
+		visited[side] = (uint64_t *) search_alloc( (num_state + 63) / 64, sizeof(uint64_t));
+		bit_set( visited[side], root[side]);
+		list_push( &frontier[side], root[side]);
+	}
+	*num_visited = (root[0] == root[1]) ? 1 : 2;
+	if (root[0] == root[1])
+	{
+		meet = meet_parent = root[0];
+		meet_side = 0;
+	}
+
+	while (meet_side < 0 && frontier[0].size > 0 && frontier[1].size > 0)
+	{
+		int side = (frontier[0].size <= frontier[1].size) ? 0 : 1;
+
+		level.size = 0;
+		for (long long k = 0; k < frontier[side].size && meet_side < 0; k++)
+		{
+			t_index state = frontier[side].item[k];
+			int n = graph_next( graph, state, &next);
+
+			for (int i = 0; i < n; i++)
+			{
+				if (bit_test( visited[side], next[i]))
+					continue;
+				if (bit_test( visited[!side], next[i]))
+				{
+					meet = (t_index) next[i];
+					meet_parent = state;
+					meet_side = side;
+					break;
+				}
+				bit_set( visited[side], next[i]);
+				parent[next[i]] = state;
+				list_push( &level, (t_index) next[i]);
+				(*num_visited)++;
+			}
+		}
+
+		// 새 층이 이 쪽의 frontier
+		t_list tmp = frontier[side];
+		frontier[side] = level;
+		level = tmp;
+	}
+
+	t_state *path = NULL;
+	*length = 0;
+	if (meet_side >= 0)
+	{
+		// meet_side 쪽 root ~ meet_parent, 그리고 meet ~ 다른 쪽 root
+		int n1 = (meet == meet_parent) ? 0 : path_length( parent, meet_parent, root[meet_side]);
+		int n2 = path_length( parent, meet, root[!meet_side]);
+
+		*length = n1 + n2;
+		path = (t_state *) malloc( *length * sizeof(t_state));
+		trace_path( parent, meet_parent, path, n1, 1);
+		trace_path( parent, meet, path + n1, n2, 0);
+
+		// 목적 상태 쪽에서 만났으면 경로를 뒤집음
+		for (int i = 0; meet_side == 1 && i < *length / 2; i++)
+		{
+			t_state t = path[i];
+			path[i] = path[*length - 1 - i];
+			path[*length - 1 - i] = t;
+		}
+	}
+
+	free( level.item);
+	for (int side = 0; side < 2; side++)
+	{
+		free( frontier[side].item);
+		free( visited[side]);
+	}
+	free( parent);
+	return path;
+}
+
+// 허용되는 상태들을 vertex로 하는 비트 집합 그래프
+// [output] vertex : vertex 번호 -> 상태
+// return value : 0 성공, -1 상태가 너무 많음
+static int puzzle_bitgraph( t_graph *state_graph, t_bitgraph *graph, t_state **vertex)
+{
+	const t_puzzle *puzzle = state_graph->puzzle;
+	t_state num_state = state_graph->num_vertex;
+	int num_vertex = 0;
+
+	if (puzzle->num_entity > BITGRAPH_MAX_ENTITY)
+		return -1;
+
+	// 상태 번호 -> vertex 번호 (허용되지 않는 상태는 -1)
+	int32_t *index = (int32_t *) search_alloc( num_state, sizeof(int32_t));
+	for (t_state s = 0; s < num_state; s++)
+	{
+		if (puzzle_is_dead_end( puzzle, s))
+			index[s] = -1;
+		else if (num_vertex == BITGRAPH_MAX_VERTEX)
+		{
+			free( index);
+			return -1;
+		}
+		else
+			index[s] = num_vertex++;
+	}
+
+	*vertex = (t_state *) search_alloc( num_vertex, sizeof(t_state));
+	if (bitgraph_init( graph, num_vertex) < 0)
+	{
+		fprintf( stderr, "Not enough memory for the adjacency matrix of %d states\n", num_vertex);
+		exit( 1);
+	}
+
+	const t_index *next;
+	for (t_state s = 0; s < num_state; s++)
+	{
+		if (index[s] < 0)
+			continue;
+
+		uint64_t *row = bitgraph_row( graph, index[s]);
+		int n = graph_next( state_graph, s, &next);
+
+		(*vertex)[index[s]] = s;
+		for (int i = 0; i < n; i++)
+			bit_set( row, index[next[i]]);
+	}
+
+	free( index);
+	return 0;
+}
+
+static t_state *puzzle_bitbfs( t_graph *graph, long long *num_visited, int *length)
+{
+	t_bitgraph bitgraph;
+	t_state *vertex;
+
+	*num_visited = 0;
+	*length = -1;
+	if (puzzle_bitgraph( graph, &bitgraph, &vertex) < 0)
+		return NULL;
+
+	// 초기 상태와 목적 상태는 가장 작은, 가장 큰 번호의 상태이므로 첫 vertex, 마지막 vertex
+	int num_word = bitgraph.num_word;
+	int goal = bitgraph.num_vertex - 1;
+	uint64_t *visited = (uint64_t *) search_alloc( num_word, sizeof(uint64_t));
+	int num_level = 0, capacity = 16;
+	uint64_t **level = (uint64_t **) search_alloc( capacity, sizeof(uint64_t *)); // level[d] : 거리가 d인 상태들
+
+	level[num_level] = (uint64_t *) search_alloc( num_word, sizeof(uint64_t));
+	bit_set( level[num_level++], 0);
+	bit_set( visited, 0);
+	*num_visited = 1;
+
+	while (!bit_test( visited, goal))
+	{
+		uint64_t *frontier = level[num_level-1];
+		uint64_t *next = (uint64_t *) search_alloc( num_word, sizeof(uint64_t));
+		long long count = 0;
+
+		// 현재 층의 상태마다 인접 행을 OR
+		for (int w = 0; w < num_word; w++)
+		{
+			for (uint64_t bits = frontier[w]; bits != 0; bits &= bits - 1)
+			{
+				const uint64_t *row = bitgraph_row( &bitgraph, w * 64 + __builtin_ctzll( bits));
+
+				for (int k = 0; k < num_word; k++)
+					next[k] |= row[k];
+			}
+		}
+
+		// 방문하지 않은 상태만 다음 층으로
+		for (int k = 0; k < num_word; k++)
+		{
+			next[k] &= ~visited[k];
+			visited[k] |= next[k];
+			count += __builtin_popcountll( next[k]);
+		}
+
+		if (count == 0)
+		{
+			free( next);
+			break;
+		}
+		*num_visited += count;
+
+		if (num_level == capacity)
+		{
+			capacity *= 2;
+			level = (uint64_t **) realloc( level, capacity * sizeof(uint64_t *));
+		}
+		level[num_level++] = next;
+	}
+
+	t_state *path = NULL;
+	*length = 0;
+	if (bit_test( visited, goal))
+	{
+		// 목적 상태에서 한 층씩 앞 층의 인접 상태로 (그래프는 대칭)
+		int v = goal;
+
+		*length = num_level;
+		path = (t_state *) malloc( num_level * sizeof(t_state));
+		path[num_level-1] = vertex[v];
+		for (int d = num_level - 2; d >= 0; d--)
+		{
+			const uint64_t *row = bitgraph_row( &bitgraph, v);
+			int w = 0;
+
+			while ((row[w] & level[d][w]) == 0)
+				w++;
+			v = w * 64 + __builtin_ctzll( row[w] & level[d][w]);
+			path[d] = vertex[v];
+		}
+	}
+
+	for (int d = 0; d < num_level; d++)
+		free( level[d]);
+	free( level);
+	free( visited);
+	free( vertex);
+	bitgraph_free( &bitgraph);
+	return path;
+}
@@ -0,0 +1,61 @@
+// 농부, 늑대, 염소, 양배추 퍼즐의 컴파일 시간 표
+// g++ -O2 -std=c++17 -o pwgc_static pwgc_static.cpp
+// pwgc_static [state] : state (기본 0)에서 목적 상태까지 가장 적게 건너는 경로
+
+#include <cstdio> // printf
+#include <cstdlib> // atoi
+
+#include "pwgc_static.hpp"
+
+#define PEASANT 0x08
+#define WOLF	0x04
+#define GOAT	0x02
+#define CABBAGE	0x01
+
+struct pwgc_rules
+{
+	static constexpr int num_entity = 4;
+	static constexpr uint32_t mover = PEASANT;
+	static constexpr int capacity = 2;
+	static constexpr uint32_t conflict[] = { WOLF | GOAT, GOAT | CABBAGE};
+};
+
+typedef pwgc::table<pwgc_rules> table;
+
+// pwgc.c의 is_dead_end (3, 6, 7, 8, 9, 12)와 같은지 컴파일할 때 확인
+static_assert( table::tables.dead[0] == ((1 << 3) | (1 << 6) | (1 << 7) | (1 << 8) | (1 << 9) | (1 << 12)), "dead-end states");
+static_assert( table::tables.distance[0] == 7, "shortest solution");
+
+static void print_state( uint32_t state)
+{
+	printf( "<%d%d%d%d>\n", (state & PEASANT) >> 3, (state & WOLF) >> 2, (state & GOAT) >> 1, state & CABBAGE);
+}
+
+int main( int argc, char **argv)
+{
+	uint32_t state = (argc > 1) ? (uint32_t) atoi( argv[1]) : 0;
+	uint32_t path[table::num_state];
+
+	if (state >= table::num_state)
+	{
+		printf( "The state should be between 0 and %u!\n", table::num_state - 1);
+		return 0;
+	}
+	if (table::is_dead_end( state))
+	{
+		printf( "The state is a dead-end!\n");
+		return 0;
+	}
+
+	size_t n = table::solve( state, path);
+	if (n == 0)
+	{
+		printf( "Goal-state not reachable!\n");
+		return 0;
+	}
+
+	printf( "Goal-state found! (%zu crossings)\n", n - 1);
+	for (size_t i = 0; i < n; i++)
+		print_state( path[i]);
+	return 0;
+}
@@ -0,0 +1,163 @@
+#ifndef PWGC_STATIC_HPP
+#define PWGC_STATIC_HPP
+
+// 컴파일 시간에 만드는 강 건너기 퍼즐의 표
+// 규칙(개체 수, mover, 배에 탈 수 있는 수, conflict)을 담은 Rules 클래스로부터
+// 허용되지 않는 상태(dead-end)의 비트 집합, 상태마다의 다음 상태 표, 목적 상태까지 가장 짧게 가는 다음 상태 표를
+// constexpr 함수로 만들어 실행 파일에 상수로 넣는다. 실행 중에는 규칙을 검사하지 않고 표만 읽음
+// 상태 번호는 pwgc.c와 같음 (개체마다 한 비트, 0 : 처음 강가, 1 : 반대편 강가)
+//
+// Rules의 형식
+//   static constexpr int num_entity;          개체의 수 (MAX_STATIC_ENTITY 이하)
+//   static constexpr uint32_t mover;          배를 젓는 개체의 비트
+//   static constexpr int capacity;            배에 탈 수 있는 개체의 수 (mover 포함)
+//   static constexpr uint32_t conflict[];     mover 없이 한 강가에 모두 있으면 안 되는 개체들의 비트
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+
+namespace pwgc
+{
+
+// 표는 상태 수 x 상태 수에 비례하는 시간에 만들어지므로 작은 퍼즐만
+const int MAX_STATIC_ENTITY = 10;
+
+template <class Rules>
+struct table
+{
+	static_assert( Rules::num_entity >= 1 && Rules::num_entity <= MAX_STATIC_ENTITY, "too many entities for a compile-time table");
+
+	static constexpr uint32_t num_state = (uint32_t) 1 << Rules::num_entity;
+	static constexpr uint32_t goal = num_state - 1;
+	static constexpr uint32_t none = num_state;	// 목적 상태에 갈 수 없음
+	static constexpr int num_conflict = sizeof(Rules::conflict) / sizeof(Rules::conflict[0]);
+
+	// 한 상태에서 가능한 이동의 최대 수 : sum C(num_entity - 1, j), j = 0 ~ capacity - 1
+	static constexpr int count_moves()
+	{
+		int num_move = 0, comb = 1;
+
+		for (int j = 0; j < Rules::capacity && j < Rules::num_entity; j++)
+		{
+			num_move += comb;
+			comb = comb * (Rules::num_entity - 1 - j) / (j + 1);
+		}
+		return num_move;
+	}
+
+	static constexpr int max_move = count_moves();
+
+	struct data
+	{
+		uint64_t dead[(num_state + 63) / 64];	// 허용되지 않는 상태의 비트 집합
+		uint32_t num_next[num_state];
+		uint32_t next[num_state][max_move];		// next[s][0 ~ num_next[s]-1] : s의 다음 상태들
+		uint32_t toward_goal[num_state];		// 목적 상태까지 가장 짧은 경로의 다음 상태 (none : 갈 수 없음)
+		uint32_t distance[num_state];			// 목적 상태까지 건너는 횟수
+	};
+
+	static constexpr int popcount( uint32_t x)
+	{
+		int n = 0;
+
+		for (; x != 0; x &= x - 1)
+			n++;
+		return n;
+	}
+
+	// pwgc.c의 puzzle_is_dead_end와 같음
+	static constexpr bool dead_end( uint32_t s)
+	{
+		uint32_t alone = (s & Rules::mover) ? (~s & goal) : s;
+
+		for (int i = 0; i < num_conflict; i++)
+			if ((alone & Rules::conflict[i]) == Rules::conflict[i])
+				return true;
+		return false;
+	}
+
+	static constexpr data build()
+	{
+		data d = {};
+
+		for (uint32_t s = 0; s < num_state; s++)
+			if (dead_end( s))
+				d.dead[s / 64] |= (uint64_t) 1 << (s % 64);
+
+		// mover 쪽 강가의 개체들 중 capacity - 1 개 이하를 태우는 모든 부분집합 (허용되지 않는 상태에서는 나가지 않음)
+		for (uint32_t s = 0; s < num_state; s++)
+		{
+			if (dead_end( s))
+				continue;
+
+			uint32_t side = ((s & Rules::mover) ? s : (~s & goal)) & ~Rules::mover;
+			for (uint32_t cargo = 0; cargo < num_state; cargo++)
+			{
+				if ((cargo & ~side) != 0 || popcount( cargo) >= Rules::capacity)
+					continue;
+
+				uint32_t t = s ^ Rules::mover ^ cargo;
+				if (!dead_end( t))
+					d.next[s][d.num_next[s]++] = t;
+			}
+		}
+
+		// 목적 상태에서 너비 우선 탐색 (건너기는 되돌릴 수 있으므로 같은 다음 상태 표를 사용)
+		uint32_t queue[num_state] = {};
+		uint32_t head = 0, tail = 0;
+
+		for (uint32_t s = 0; s < num_state; s++)
+		{
+			d.toward_goal[s] = none;
+			d.distance[s] = none;
+		}
+		if (!dead_end( goal))
+		{
+			d.toward_goal[goal] = goal;
+			d.distance[goal] = 0;
+			queue[tail++] = goal;
+		}
+		while (head < tail)
+		{
+			uint32_t u = queue[head++];
+
+			for (uint32_t i = 0; i < d.num_next[u]; i++)
+			{
+				uint32_t v = d.next[u][i];
+
+				if (d.distance[v] != none)
+					continue;
+				d.toward_goal[v] = u;
+				d.distance[v] = d.distance[u] + 1;
+				queue[tail++] = v;
+			}
+		}
+		return d;
+	}
+
+	static constexpr data tables = build();
+
+	static constexpr bool is_dead_end( uint32_t s)
+	{
+		return (tables.dead[s / 64] >> (s % 64)) & 1;
+	}
+
+	// s에서 목적 상태까지 가장 적게 건너는 경로 (표만 따라감)
+	// [output] path : 상태들 (s부터 목적 상태까지), distance + 1 개의 공간이 있어야 함
+	// return value : 경로의 상태 수, 갈 수 없으면 0
+	static size_t solve( uint32_t s, uint32_t *path)
+	{
+		if (s >= num_state || tables.distance[s] == none)
+			return 0;
+
+		size_t n = 0;
+		for (; s != goal; s = tables.toward_goal[s])
+			path[n++] = s;
+		path[n++] = goal;
+		return n;
+	}
+};
+
+} // namespace pwgc
+
+#endif
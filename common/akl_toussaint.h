@@ -0,0 +1,20 @@
+#ifndef AKL_TOUSSAINT_H
+#define AKL_TOUSSAINT_H
+
+#include "point.h"
+
+// Akl-Toussaint 전처리
+// x, y, x+y, x-y 가 최소/최대인 8개의 극점(extreme point)은 모두 convex hull 위에 있으므로
+// 이 점들이 이루는 팔각형의 내부에 있는 점은 convex hull의 점이 될 수 없다.
+// 정의는 hull_core.cpp (hull::core<int32_t, exact_predicate>::prefilter)
+// gcc로 빌드할 때 hull_core.cpp를 함께 컴파일하고 -lstdc++ 로 링크
+
+// 팔각형의 내부에 있는 점들을 제거하는 함수
+// 남은 점들은 points의 앞쪽으로 (순서는 유지), 제거된 점들은 뒤쪽으로 모음 (점들의 집합은 그대로)
+// 팔각형의 경계 위에 있는 점들은 남겨둠
+// [input] points : set of points
+// [input] num_point : number of points
+// return value : 남은 점의 수
+int akl_toussaint( t_point *points, int num_point);
+
+#endif
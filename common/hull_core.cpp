@@ -0,0 +1,52 @@
+// hull_core.hpp의 C 진입점들 (hull_core.h, akl_toussaint.h)
+// C 프로그램의 akl_toussaint, monotone chain은 모두 여기의 int32_t 인스턴스를 사용함
+
+#include <cstring> // memcpy
+
+#include "hull_core.hpp"
+#include "hull_core.h"
+
+extern "C"
+{
+#include "akl_toussaint.h" // akl_toussaint
+}
+
+// t_point를 그대로 hull::point<int32_t>로 사용
+static_assert( sizeof(t_point) == sizeof(hull::point<int32_t>) && offsetof(t_point, y) == offsetof(hull::point<int32_t>, y), "t_point layout");
+
+typedef hull::core<int32_t, hull::exact_predicate<int32_t> > exact_core;
+typedef hull::core<int32_t, hull::fast_predicate<int32_t> > fast_core;
+typedef hull::core<double, hull::exact_predicate<double> > double_core;
+
+extern "C" int akl_toussaint( t_point *points, int num_point)
+{
+	return (int) exact_core::prefilter( reinterpret_cast<hull::point<int32_t> *>( points), num_point);
+}
+
+extern "C" int hull_core_chain( const void *base, size_t stride, int num_point, int *pos)
+{
+	const char *b = (const char *) base;
+
+	// 구조체 안의 t_point를 복사해서 읽음
+	return (int) exact_core::chain( [b, stride]( size_t i)
+	{
+		hull::point<int32_t> p;
+		memcpy( &p, b + i * stride, sizeof(p));
+		return p;
+	}, num_point, pos);
+}
+
+extern "C" int hull_core_int( t_point *points, int num_point, t_point *hull)
+{
+	return (int) exact_core::convex_hull( reinterpret_cast<hull::point<int32_t> *>( points), num_point, reinterpret_cast<hull::point<int32_t> *>( hull));
+}
+
+extern "C" int hull_core_int_fast( t_point *points, int num_point, t_point *hull)
+{
+	return (int) fast_core::convex_hull( reinterpret_cast<hull::point<int32_t> *>( points), num_point, reinterpret_cast<hull::point<int32_t> *>( hull));
+}
+
+extern "C" int hull_core_double( double *xy, int num_point, double *hull)
+{
+	return (int) double_core::convex_hull( reinterpret_cast<hull::point<double> *>( xy), num_point, reinterpret_cast<hull::point<double> *>( hull));
+}
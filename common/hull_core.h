@@ -0,0 +1,41 @@
+#ifndef HULL_CORE_H
+#define HULL_CORE_H
+
+#include <stddef.h> // size_t
+
+#include "point.h"
+
+// hull_core.hpp (C++ hull 코어)의 C 진입점들, 정의는 hull_core.cpp
+// gcc로 빌드할 때 hull_core.cpp를 함께 컴파일하고 -lstdc++ 로 링크
+// 예) gcc -O2 -pthread efficient_convex_hull.c ../common/hull_core.cpp -lstdc++ -lm
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// monotone chain (hull::core<int32_t, exact_predicate>::chain)
+// [input] base, stride : i 번째 점은 base + i * stride 바이트에 있는 t_point (t_point로 시작하는 구조체의 배열도 가능)
+// [input] num_point : number of points (x, y 순서로 정렬된 상태)
+// [output] pos : 꼭짓점들의 위치 (가장 왼쪽(아래)의 점부터 반시계 방향, 한 직선 위의 점들은 양 끝 점만)
+//                num_point + 2 개의 공간이 있어야 함
+// return value : 꼭짓점의 수 (점이 하나이거나 모든 점이 같으면 1)
+int hull_core_chain( const void *base, size_t stride, int num_point, int *pos);
+
+// 전처리 -> 정렬 -> monotone chain (points의 순서는 바뀜)
+// hull_core_int : 정확한 방향 판정 (모든 int 좌표)
+// hull_core_int_fast : 빠른 방향 판정 (좌표의 절댓값이 2^30 보다 작을 때만 정확)
+// [output] hull : 꼭짓점들 (num_point + 2 개의 공간이 있어야 함)
+// return value : 꼭짓점의 수 (num_point == 0 이면 0)
+int hull_core_int( t_point *points, int num_point, t_point *hull);
+int hull_core_int_fast( t_point *points, int num_point, t_point *hull);
+
+// double 좌표 (x0, y0, x1, y1, ...)의 convex hull (xy의 순서는 바뀜)
+// [output] hull : 꼭짓점들의 좌표 (2 * (num_point + 2) 개의 공간이 있어야 함)
+// return value : 꼭짓점의 수
+int hull_core_double( double *xy, int num_point, double *hull);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,322 @@
+#ifndef HULL_CORE_HPP
+#define HULL_CORE_HPP
+
+// 헤더만으로 된 C++ convex hull 코어
+// 좌표의 타입(int32_t, int64_t, float, double)과 방향 판정 정책(predicate)을
+// 템플릿 인자로 받아 컴파일 시간에 정해지므로, 좌표 타입마다 따로 관리하는 코드 없이 각각에 맞게 최적화된 코드가 만들어진다.
+// 알고리즘 : Akl-Toussaint 전처리 -> (x, y) 순서로 정렬 -> monotone chain
+// 꼭짓점은 가장 왼쪽(아래)의 점부터 반시계 방향, 한 직선 위의 점들은 양 끝 점만
+// C 프로그램들의 akl_toussaint, monotone_chain은 hull_core.cpp의 int32_t 인스턴스를 사용함
+
+#include <cstddef> // size_t
+#include <cstdint> // int32_t, int64_t
+#include <cmath> // std::fma, std::fabs
+#include <algorithm> // std::sort, std::swap, std::copy
+#include <vector> // std::vector
+
+namespace hull
+{
+
+template <class T>
+struct point
+{
+	T x;
+	T y;
+};
+
+// (x, y) 순서로 p가 q보다 앞이면 true
+template <class T>
+inline bool before( const point<T> &p, const point<T> &q)
+{
+	return p.x < q.x || (p.x == q.x && p.y < q.y);
+}
+
+template <class T>
+inline bool same( const point<T> &p, const point<T> &q)
+{
+	return p.x == q.x && p.y == q.y;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 좌표 타입마다 중간 계산에 쓰는 넓은 타입
+// wide : 좌표의 차, x + y 등 (넘치지 않음)
+template <class T> struct coord_traits;
+
+template <> struct coord_traits<int32_t> { typedef int64_t wide; };
+template <> struct coord_traits<int64_t> { typedef __int128 wide; };
+template <> struct coord_traits<float> { typedef double wide; };
+template <> struct coord_traits<double> { typedef double wide; };
+
+////////////////////////////////////////////////////////////////////////////////
+// 실수 좌표의 정확한 방향 판정 (Shewchuk의 expansion 연산)
+// 곱은 fma로 (곱, 오차) 두 double로 정확하게 나타내고, 그 합을 서로 겹치지 않는 double들의 합(expansion)으로 정확하게 구해
+// 가장 큰 성분의 부호를 방향으로 한다. (overflow, underflow가 일어나지 않는 범위의 좌표에서 정확)
+namespace detail
+{
+
+// a + b = s + e (Knuth)
+inline void two_sum( double a, double b, double &s, double &e)
+{
+	s = a + b;
+	double bv = s - a;
+	double av = s - bv;
+	e = (a - av) + (b - bv);
+}
+
+// a * b = p + e
+inline void two_product( double a, double b, double &p, double &e)
+{
+	p = a * b;
+	e = std::fma( a, b, -p);
+}
+
+// 크기 순의 expansion e (길이 n)에 b를 더함 (0인 성분은 버림)
+// return value : 새 길이
+inline int grow_expansion( double *e, int n, double b)
+{
+	double q = b;
+	int k = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		double s, err;
+		two_sum( q, e[i], s, err);
+		q = s;
+		if (err != 0)
+			e[k++] = err;
+	}
+	if (q != 0 || k == 0)
+		e[k++] = q;
+	return k;
+}
+
+// (a - o) x (b - o) = a x b + o x a + b x o 의 부호
+inline int orient_exact( double ox, double oy, double ax, double ay, double bx, double by)
+{
+	const double term[6][2] =
+	{
+		{ ax, by}, { -ay, bx},
+		{ ox, ay}, { -oy, ax},
+		{ bx, oy}, { -by, ox},
+	};
+	double e[12];
+	int n = 0;
+
+	for (int i = 0; i < 6; i++)
+	{
+		double p, err;
+		two_product( term[i][0], term[i][1], p, err);
+		n = grow_expansion( e, n, err);
+		n = grow_expansion( e, n, p);
+	}
+	return (e[n-1] > 0) - (e[n-1] < 0);
+}
+
+// 먼저 double로 계산하고 오차 한계 안이면 정확하게 다시 계산
+inline int orient_filtered( double ox, double oy, double ax, double ay, double bx, double by)
+{
+	double left = (ax - ox) * (by - oy);
+	double right = (ay - oy) * (bx - ox);
+	double det = left - right;
+	double bound = 3.3306690738754716e-16 * (std::fabs( left) + std::fabs( right)); // (3 + 16 eps) eps
+
+	if (det > bound) return +1;
+	if (-det > bound) return -1;
+	return orient_exact( ox, oy, ax, ay, bx, by);
+}
+
+} // namespace detail
+
+////////////////////////////////////////////////////////////////////////////////
+// 방향 판정 정책
+// static int orient( o, a, b) : +1 b가 직선 o->a 의 왼쪽, -1 오른쪽, 0 한 직선 위
+
+// 정확한 방향 판정
+template <class T> struct exact_predicate;
+
+// 좌표의 차가 2^31 보다 작으면 64비트, 아니면 128비트 (common/orient.h와 같음)
+template <>
+struct exact_predicate<int32_t>
+{
+	static int orient( const point<int32_t> &o, const point<int32_t> &a, const point<int32_t> &b)
+	{
+		int64_t ax = (int64_t) a.x - o.x, ay = (int64_t) a.y - o.y;
+		int64_t bx = (int64_t) b.x - o.x, by = (int64_t) b.y - o.y;
+		const int64_t limit = (int64_t) 1 << 31;
+
+		if (ax > -limit && ax < limit && ay > -limit && ay < limit && bx > -limit && bx < limit && by > -limit && by < limit)
+		{
+			int64_t d = ax * by - ay * bx;
+			return (d > 0) - (d < 0);
+		}
+		__int128 d = (__int128) ax * by - (__int128) ay * bx;
+		return (d > 0) - (d < 0);
+	}
+};
+
+// 128비트 (좌표의 절댓값이 2^62 보다 작을 때 정확)
+template <>
+struct exact_predicate<int64_t>
+{
+	static int orient( const point<int64_t> &o, const point<int64_t> &a, const point<int64_t> &b)
+	{
+		__int128 ax = (__int128) a.x - o.x, ay = (__int128) a.y - o.y;
+		__int128 bx = (__int128) b.x - o.x, by = (__int128) b.y - o.y;
+		__int128 d = ax * by - ay * bx;
+		return (d > 0) - (d < 0);
+	}
+};
+
+template <>
+struct exact_predicate<float>
+{
+	static int orient( const point<float> &o, const point<float> &a, const point<float> &b)
+	{
+		return detail::orient_filtered( o.x, o.y, a.x, a.y, b.x, b.y);
+	}
+};
+
+template <>
+struct exact_predicate<double>
+{
+	static int orient( const point<double> &o, const point<double> &a, const point<double> &b)
+	{
+		return detail::orient_filtered( o.x, o.y, a.x, a.y, b.x, b.y);
+	}
+};
+
+// 빠른 방향 판정 : 넓은 타입으로 한 번만 계산 (분기가 없음)
+// 정수는 int32_t 좌표의 절댓값이 2^30, int64_t는 2^62 보다 작을 때 정확, 실수는 반올림 오차가 있을 수 있음
+template <class T>
+struct fast_predicate
+{
+	static int orient( const point<T> &o, const point<T> &a, const point<T> &b)
+	{
+		typedef typename coord_traits<T>::wide wide;
+		wide d = ((wide) a.x - o.x) * ((wide) b.y - o.y) - ((wide) a.y - o.y) * ((wide) b.x - o.x);
+		return (d > 0) - (d < 0);
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// T : 좌표 타입, Predicate : 방향 판정 정책
+template <class T, class Predicate = exact_predicate<T> >
+struct core
+{
+	typedef point<T> point_type;
+	typedef typename coord_traits<T>::wide wide;
+
+	// Akl-Toussaint 전처리
+	// 8 방향의 극점들로 이루어진 다각형의 (경계를 제외한) 안쪽 점들을 뒤로 보냄 (남은 점들의 순서는 유지)
+	// 극점들은 모두 입력 점이므로 극점을 계산할 때의 반올림과 관계없이 안쪽 점은 convex hull의 꼭짓점이 아님
+	// return value : 앞쪽에 남은 점의 수
+	static size_t prefilter( point_type *p, size_t n)
+	{
+		if (n == 0)
+			return 0;
+
+		// 반시계 방향 : min x, min x+y, min y, max x-y, max x, max x+y, max y, min x-y
+		size_t e[8] = { 0, 0, 0, 0, 0, 0, 0, 0};
+		for (size_t i = 1; i < n; i++)
+		{
+			const point_type &q = p[i];
+			wide s = (wide) q.x + q.y, d = (wide) q.x - q.y;
+
+			if (q.x < p[e[0]].x) e[0] = i;
+			if (s < (wide) p[e[1]].x + p[e[1]].y) e[1] = i;
+			if (q.y < p[e[2]].y) e[2] = i;
+			if (d > (wide) p[e[3]].x - p[e[3]].y) e[3] = i;
+			if (q.x > p[e[4]].x) e[4] = i;
+			if (s > (wide) p[e[5]].x + p[e[5]].y) e[5] = i;
+			if (q.y > p[e[6]].y) e[6] = i;
+			if (d < (wide) p[e[7]].x - p[e[7]].y) e[7] = i;
+		}
+
+		// 같은 점이 이어지는 극점은 하나로
+		point_type poly[9];
+		int m = 0;
+		for (int k = 0; k < 8; k++)
+			if (m == 0 || !same( poly[m-1], p[e[k]]))
+				poly[m++] = p[e[k]];
+		while (m > 1 && same( poly[m-1], poly[0]))
+			m--;
+		if (m < 3)
+			return n;
+		poly[m] = poly[0];
+
+		// 남길 점들을 앞으로 모음
+		size_t keep = 0;
+		for (size_t i = 0; i < n; i++)
+			if (!strictly_inside( poly, m, p[i]))
+				std::swap( p[keep++], p[i]);
+		return keep;
+	}
+
+	// monotone chain
+	// 점들을 한 번 훑으면서 lower hull은 pos의 앞쪽에서부터, upper hull은 뒤쪽에서부터 쌓고 (두 스택은 겹치지 않음)
+	// 마지막에 upper hull을 lower hull 뒤로 옮긴다. 점 대신 위치를 쌓으므로 점의 배열 형식과 관계없이 사용
+	// [input] at : at( i)가 (x, y) 순서로 정렬된 i 번째 점을 돌려주는 함수 객체
+	// [output] pos : 꼭짓점들의 위치 (n + 2 개의 공간이 있어야 함)
+	// return value : 꼭짓점의 수 (점이 하나이거나 모든 점이 같으면 1)
+	template <class At>
+	static size_t chain( At at, size_t n, int *pos)
+	{
+		size_t lower = 0;		// pos[0] ~ pos[lower-1] : lower hull (왼쪽 -> 오른쪽)
+		size_t upper = n + 2;	// pos[upper] ~ pos[n+1] : upper hull (오른쪽 -> 왼쪽)
+
+		for (size_t i = 0; i < n; i++)
+		{
+			point_type q = at( i);
+
+			while (lower >= 2 && Predicate::orient( at( pos[lower-2]), at( pos[lower-1]), q) <= 0) lower--;
+			pos[lower++] = (int) i;
+
+			while (upper <= n && Predicate::orient( at( pos[upper+1]), at( pos[upper]), q) >= 0) upper++;
+			pos[--upper] = (int) i;
+		}
+
+		// upper hull의 양 끝 점은 lower hull과 같으므로 그 사이의 점들만 옮김
+		size_t k = lower;
+		if (n > upper)
+		{
+			std::copy( pos + upper + 1, pos + n + 1, pos + lower);
+			k += n - upper;
+		}
+		if (k < 2 || same( at( pos[0]), at( pos[1])))
+			k = 1;
+		return k;
+	}
+
+	// 전처리 -> 정렬 -> monotone chain (p의 순서는 바뀜)
+	// [output] hull : 꼭짓점들 (n + 2 개의 공간이 있어야 함)
+	// return value : 꼭짓점의 수 (n == 0 이면 0)
+	static size_t convex_hull( point_type *p, size_t n, point_type *hull)
+	{
+		if (n == 0)
+			return 0;
+
+		size_t m = prefilter( p, n);
+		std::sort( p, p + m, before<T>);
+
+		std::vector<int> pos( m + 2);
+		size_t k = chain( [p]( size_t i) { return p[i]; }, m, pos.data());
+		for (size_t i = 0; i < k; i++)
+			hull[i] = p[pos[i]];
+		return k;
+	}
+
+private:
+	// q가 다각형 poly (꼭짓점 m 개, poly[m] == poly[0])의 경계를 제외한 안쪽에 있는지
+	static bool strictly_inside( const point_type *poly, int m, const point_type &q)
+	{
+		bool inside = true;
+
+		for (int k = 0; k < m; k++)
+			inside &= (Predicate::orient( poly[k], poly[k+1], q) > 0);
+		return inside;
+	}
+};
+
+} // namespace hull
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef HULL_IO_H
+#define HULL_IO_H
+
+#include <stdio.h> // FILE, fopen, fread
+#include <stdlib.h> // malloc, free
+#include <string.h> // memcpy, memcmp
+#include <unistd.h> // write, close, sysconf
+#include <fcntl.h> // open
+#include <sys/uio.h> // writev
+#include <sys/mman.h> // mmap, madvise
+#include <sys/stat.h> // fstat
+
+#include "point.h"
+
+// convex hull 바이너리 파일 형식
+// [t_hull_header] [t_point x num_point] [int x num_hull]
+// 점들은 (int x, int y) 쌍, hull은 점들의 index (가장 왼쪽(아래)의 점부터 반시계 방향)
+// 바이트 순서는 파일을 쓴 컴퓨터의 순서를 따름
+#define HULL_MAGIC		"HULL"
+#define HULL_VERSION	1
+
+typedef struct
+{
+	char magic[4];			// HULL_MAGIC
+	unsigned int version;	// HULL_VERSION
+	unsigned int num_point;
+	unsigned int num_hull;
+} t_hull_header;
+
+// iov의 내용을 모두 쓸 때까지 writev를 반복
+// return value : 0 성공, -1 실패
+static inline int hull_writev( int fd, struct iovec *iov, int num_iov)
+{
+	while (num_iov > 0)
+	{
+		ssize_t n = writev( fd, iov, num_iov);
+		if (n < 0)
+			return -1;
+
+		// 다 쓴 iovec은 건너뛰고, 일부만 쓴 iovec은 남은 부분부터
+		while (num_iov > 0 && (size_t) n >= iov->iov_len)
+		{
+			n -= iov->iov_len;
+			iov++;
+			num_iov--;
+		}
+		if (num_iov > 0)
+		{
+			iov->iov_base = (char *) iov->iov_base + n;
+			iov->iov_len -= n;
+		}
+	}
+	return 0;
+}
+
+// 점들과 convex hull(점들의 index)을 바이너리 형식으로 fd에 쓰는 함수
+// 헤더, 점, index를 복사하지 않고 한 번의 writev로 씀
+// return value : 0 성공, -1 실패
+static inline int write_hull( int fd, t_point *points, int num_point, int *hull, int num_hull)
+{
+	t_hull_header header;
+
+	memcpy( header.magic, HULL_MAGIC, 4);
+	header.version = HULL_VERSION;
+	header.num_point = num_point;
+	header.num_hull = num_hull;
+
+	struct iovec iov[3] =
+	{
+		{ &header, sizeof(header)},
+		{ points, num_point * sizeof(t_point)},
+		{ hull, num_hull * sizeof(int)},
+	};
+	return hull_writev( fd, iov, 3);
+}
+
+// write_hull로 쓴 파일을 읽는 함수
+// [output] points, num_point : 점들 (호출한 쪽에서 free)
+// [output] hull, num_hull : convex hull (points의 index, 호출한 쪽에서 free)
+// return value : 0 성공, -1 실패 (파일을 열 수 없거나 형식이 맞지 않음)
+static inline int read_hull( const char *filename, t_point **points, int *num_point, int **hull, int *num_hull)
+{
+	t_hull_header header;
+	FILE *fp = fopen( filename, "rb");
+
+	if (fp == NULL)
+		return -1;
+
+	if (fread( &header, sizeof(header), 1, fp) != 1
+		|| memcmp( header.magic, HULL_MAGIC, 4) != 0 || header.version != HULL_VERSION)
+	{
+		fclose( fp);
+		return -1;
+	}
+
+	*points = (t_point *) malloc( header.num_point * sizeof(t_point) + 1);
+	*hull = (int *) malloc( header.num_hull * sizeof(int) + 1);
+	if (*points == NULL || *hull == NULL
+		|| fread( *points, sizeof(t_point), header.num_point, fp) != header.num_point
+		|| fread( *hull, sizeof(int), header.num_hull, fp) != header.num_hull)
+	{
+		free( *points);
+		free( *hull);
+		fclose( fp);
+		return -1;
+	}
+	fclose( fp);
+
+	*num_point = header.num_point;
+	*num_hull = header.num_hull;
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 점 읽기
+// 바이너리 형식의 파일(헤더의 점들만 읽음) 또는 (int x, int y) 쌍이 이어진 파일을 chunk 단위로 읽음
+// 파일은 mmap하여 읽은 부분은 바로 반환하므로 (MADV_DONTNEED) 파일의 크기와 관계없이 메모리를 적게 사용
+// 파일 이름이 "-"이면 stdin에서 읽음
+typedef struct
+{
+	// mmap한 파일
+	char *base;
+	size_t size;
+	t_point *points;
+	size_t pos;				// 다음에 읽을 점의 index
+
+	// stdin
+	FILE *fp;
+	t_point pending[2];		// 헤더인지 검사하려고 먼저 읽은 점들
+	int num_pending;
+
+	long long remain;		// 남은 점의 수 (알 수 없으면 -1)
+} t_point_reader;
+
+// return value : 0 성공, -1 실패
+static inline int point_reader_open( t_point_reader *r, const char *filename)
+{
+	t_hull_header header;
+
+	memset( r, 0, sizeof(t_point_reader));
+	r->remain = -1;
+
+	if (strcmp( filename, "-") == 0)
+	{
+		r->fp = stdin;
+
+		size_t n = fread( &header, 1, sizeof(header), r->fp);
+		if (n == sizeof(header) && memcmp( header.magic, HULL_MAGIC, 4) == 0)
+			r->remain = header.num_point;
+		else
+		{
+			// 헤더가 아니면 읽은 바이트는 점들
+			memcpy( r->pending, &header, n);
+			r->num_pending = n / sizeof(t_point);
+		}
+		return 0;
+	}
+
+	int fd = open( filename, O_RDONLY);
+	if (fd < 0)
+		return -1;
+
+	struct stat st;
+	if (fstat( fd, &st) < 0)
+	{
+		close( fd);
+		return -1;
+	}
+	r->size = st.st_size;
+	r->base = (r->size > 0) ? (char *) mmap( NULL, r->size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+	close( fd);
+
+	if (r->base == MAP_FAILED)
+		return -1;
+	madvise( r->base, r->size, MADV_SEQUENTIAL);
+
+	r->points = (t_point *) r->base;
+	r->remain = r->size / sizeof(t_point);
+	if (r->size >= sizeof(header) && memcmp( r->base, HULL_MAGIC, 4) == 0)
+	{
+		memcpy( &header, r->base, sizeof(header));
+		r->points = (t_point *)(r->base + sizeof(header));
+		r->remain = (r->size - sizeof(header)) / sizeof(t_point);
+		if (header.num_point < r->remain)
+			r->remain = header.num_point;
+	}
+	return 0;
+}
+
+// 최대 max 개의 점을 buf에 읽음
+// return value : 읽은 점의 수, 더 읽을 점이 없으면 0
+static inline int point_reader_read( t_point_reader *r, t_point *buf, int max)
+{
+	int n = 0;
+
+	if (r->remain >= 0 && r->remain < max)
+		max = (int) r->remain;
+
+	if (r->fp != NULL)
+	{
+		while (n < max && r->num_pending > 0)
+		{
+			buf[n++] = r->pending[0];
+			r->pending[0] = r->pending[1];
+			r->num_pending--;
+		}
+		n += fread( buf + n, sizeof(t_point), max - n, r->fp);
+	}
+	else if (max > 0)
+	{
+		memcpy( buf, r->points + r->pos, max * sizeof(t_point));
+		n = max;
+
+		// 다 읽은 페이지는 반환
+		long page = sysconf( _SC_PAGESIZE);
+		size_t from = ((char *)(r->points + r->pos) - r->base) / page * page;
+		r->pos += n;
+		size_t to = ((char *)(r->points + r->pos) - r->base) / page * page;
+		if (to > from)
+			madvise( r->base + from, to - from, MADV_DONTNEED);
+	}
+
+	if (r->remain >= 0)
+		r->remain -= n;
+	return n;
+}
+
+static inline void point_reader_close( t_point_reader *r)
+{
+	if (r->base != NULL)
+		munmap( r->base, r->size);
+}
+
+#endif
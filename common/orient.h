@@ -0,0 +1,51 @@
+#ifndef ORIENT_H
+#define ORIENT_H
+
+#include "point.h"
+
+// 정확한 방향 판정 (orientation predicate)
+// 좌표가 32비트 정수 전체 범위이면 좌표의 차는 33비트, 두 차의 곱은 66비트이므로 int, float은 물론 64비트 정수로도 넘칠 수 있다.
+// 좌표의 차가 모두 ORIENT_FAST_LIMIT(2^31) 보다 작으면 (곱 < 2^62) 64비트 정수로,
+// 그렇지 않으면 128비트 정수로 계산한다. (RANGE 10000 과 같이 작은 좌표는 항상 64비트로 계산됨)
+
+typedef __int128 t_wide; // 방향 판정, 거리의 제곱
+
+#define ORIENT_FAST_LIMIT	(1LL << 31)
+
+// |v| < ORIENT_FAST_LIMIT
+#define ORIENT_IS_SMALL(v)	((unsigned long long)((v) + ORIENT_FAST_LIMIT) < (unsigned long long)(2 * ORIENT_FAST_LIMIT))
+
+// 세 점 o, a, b 의 방향 (벡터 oa와 ob의 외적)
+// return value : 양수 o->a->b 가 반시계 방향 (b가 직선 o->a 의 왼쪽), 음수 시계 방향, 0 한 직선 위
+static inline t_wide orient2d( t_point o, t_point a, t_point b)
+{
+	long long ax = (long long) a.x - o.x;
+	long long ay = (long long) a.y - o.y;
+	long long bx = (long long) b.x - o.x;
+	long long by = (long long) b.y - o.y;
+
+	if (ORIENT_IS_SMALL( ax) && ORIENT_IS_SMALL( ay) && ORIENT_IS_SMALL( bx) && ORIENT_IS_SMALL( by))
+		return ax * by - ay * bx;
+
+	return (t_wide) ax * by - (t_wide) ay * bx;
+}
+
+// orient2d의 부호
+// return value : +1 반시계 방향, -1 시계 방향, 0 한 직선 위
+static inline int orient2d_sign( t_point o, t_point a, t_point b)
+{
+	t_wide d = orient2d( o, a, b);
+
+	return (d > 0) - (d < 0);
+}
+
+// 두 점 사이의 거리의 제곱 (최대 2^65 이므로 128비트)
+static inline t_wide dist2( t_point a, t_point b)
+{
+	t_wide dx = (long long) a.x - b.x;
+	t_wide dy = (long long) a.y - b.y;
+
+	return dx * dx + dy * dy;
+}
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef POINT_H
+#define POINT_H
+
+// assignment1, assignment2의 convex hull 프로그램이 함께 사용하는 점과 선분
+
+typedef struct
+{
+	int x;
+	int y;
+} t_point;
+
+typedef struct
+{
+	t_point from;
+	t_point to;
+} t_line;
+
+#endif
@@ -0,0 +1,187 @@
+#ifndef POINTGEN_H
+#define POINTGEN_H
+
+#include <stdint.h> // uint32_t, uint64_t
+#include <string.h> // strcmp
+#include <math.h> // sqrt, log, cos, sin (link with -lm)
+#include <pthread.h> // pthread_create, pthread_join (compile with -pthread)
+
+#include "point.h"
+
+// 점 생성기
+// counter 기반 난수 생성기 Philox4x32-10을 사용하여 i 번째 점은 (seed, i)만으로 정해진다.
+// 따라서 스레드들이 점 배열을 나누어 채워도 스레드 수와 관계없이 같은 seed이면 항상 같은 점들이 만들어짐
+// 좌표는 rand()를 쓰던 때와 같이 1 ~ range
+
+#define POINTGEN_UNIFORM	0	// 정사각형 안에 균일하게
+#define POINTGEN_DISK		1	// 원판 안에 균일하게
+#define POINTGEN_CIRCLE		2	// 원 위에 (convex hull의 꼭짓점 수가 가장 많은 경우, h = n)
+#define POINTGEN_GAUSSIAN	3	// 가운데를 중심으로 한 정규 분포
+#define POINTGEN_CLUSTERED	4	// 몇 개의 군집 (군집마다 정규 분포)
+
+#define POINTGEN_NUM_CLUSTER	16
+#define POINTGEN_PAR_CUTOFF		(1 << 16)	// 이보다 점이 적으면 스레드를 만들지 않음
+
+// 같은 seed로 서로 다른 용도의 난수를 만들 때 counter의 두 번째 값으로 구분
+#define POINTGEN_STREAM_POINT	0
+#define POINTGEN_STREAM_CLUSTER	1
+#define POINTGEN_STREAM_QUERY	2
+
+static const char *pointgen_names[] = { "uniform", "disk", "circle", "gaussian", "clustered"};
+
+#define POINTGEN_NUM_DIST (int)(sizeof(pointgen_names) / sizeof(pointgen_names[0]))
+
+// 이름으로 분포를 찾는 함수
+// return value : 분포 (POINTGEN_*), 없는 경우 -1
+static inline int find_distribution( const char *name)
+{
+	for (int i = 0; i < POINTGEN_NUM_DIST; i++)
+		if (strcmp( pointgen_names[i], name) == 0)
+			return i;
+	return -1;
+}
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3")
+// 128비트 counter와 64비트 key로 32비트 난수 4개를 만듦
+static inline void philox4x32( const uint32_t counter[4], uint64_t seed, uint32_t out[4])
+{
+	uint32_t x0 = counter[0], x1 = counter[1], x2 = counter[2], x3 = counter[3];
+	uint32_t k0 = (uint32_t) seed, k1 = (uint32_t)(seed >> 32);
+
+	for (int round = 0; round < 10; round++)
+	{
+		uint64_t p0 = (uint64_t) 0xD2511F53u * x0;
+		uint64_t p1 = (uint64_t) 0xCD9E8D57u * x2;
+
+		x0 = (uint32_t)(p1 >> 32) ^ x1 ^ k0;
+		x1 = (uint32_t) p1;
+		x2 = (uint32_t)(p0 >> 32) ^ x3 ^ k1;
+		x3 = (uint32_t) p0;
+
+		k0 += 0x9E3779B9u;
+		k1 += 0xBB67AE85u;
+	}
+	out[0] = x0; out[1] = x1; out[2] = x2; out[3] = x3;
+}
+
+// (0, 1) 의 실수
+static inline double pointgen_unit( uint32_t u)
+{
+	return (u + 0.5) / 4294967296.0;
+}
+
+// 1 ~ range 로 자름
+static inline int pointgen_clamp( double v, int range)
+{
+	if (v < 1) return 1;
+	if (v > range) return range;
+	return (int) floor( v + 0.5);
+}
+
+typedef struct
+{
+	t_point *points;
+	long long lo;			// 채울 점들 : points[lo] ~ points[hi-1]
+	long long hi;
+	int distribution;
+	uint64_t seed;
+	int stream;
+	int range;
+	const double *center;	// 군집의 중심 (x, y) x POINTGEN_NUM_CLUSTER
+} t_pointgen_job;
+
+static void *pointgen_job( void *arg)
+{
+	t_pointgen_job *job = (t_pointgen_job *) arg;
+	double c = ((double) job->range + 1) / 2;		// 가운데 (range가 INT_MAX여도 넘치지 않도록 double로)
+	double radius = ((double) job->range - 1) / 2;
+	const double two_pi = 6.283185307179586;
+
+	for (long long i = job->lo; i < job->hi; i++)
+	{
+		uint32_t counter[4] = { (uint32_t) i, (uint32_t) job->stream, (uint32_t)(i >> 32), 0};
+		uint32_t u[4];
+		double r, a, x, y;
+
+		philox4x32( counter, job->seed, u);
+
+		switch (job->distribution)
+		{
+			case POINTGEN_DISK:
+				r = radius * sqrt( pointgen_unit( u[0]));
+				a = two_pi * pointgen_unit( u[1]);
+				x = c + r * cos( a);
+				y = c + r * sin( a);
+				break;
+			case POINTGEN_CIRCLE:
+				a = two_pi * pointgen_unit( u[0]);
+				x = c + radius * cos( a);
+				y = c + radius * sin( a);
+				break;
+			case POINTGEN_GAUSSIAN:
+			case POINTGEN_CLUSTERED:
+				// Box-Muller
+				r = sqrt( -2 * log( pointgen_unit( u[0])));
+				a = two_pi * pointgen_unit( u[1]);
+				if (job->distribution == POINTGEN_GAUSSIAN)
+				{
+					x = c + radius / 4 * r * cos( a);
+					y = c + radius / 4 * r * sin( a);
+				}
+				else
+				{
+					const double *center = job->center + 2 * (u[2] % POINTGEN_NUM_CLUSTER);
+					x = center[0] + radius / 32 * r * cos( a);
+					y = center[1] + radius / 32 * r * sin( a);
+				}
+				break;
+			default: // POINTGEN_UNIFORM
+				job->points[i].x = (int)(((uint64_t) u[0] * job->range) >> 32) + 1;
+				job->points[i].y = (int)(((uint64_t) u[1] * job->range) >> 32) + 1;
+				continue;
+		}
+		job->points[i].x = pointgen_clamp( x, job->range);
+		job->points[i].y = pointgen_clamp( y, job->range);
+	}
+	return NULL;
+}
+
+// num_point 개의 점을 num_thread 개의 스레드로 나누어 생성
+// [input] distribution : POINTGEN_*
+// [input] seed, stream : 같은 (seed, stream)이면 항상 같은 점들
+// [input] range : 좌표의 범위 (1 ~ range)
+// [output] points : 생성된 점들
+static inline void generate_points( t_point *points, long long num_point, int distribution, uint64_t seed, int stream, int range, int num_thread)
+{
+	// 군집의 중심은 가운데 3/4 안에 균일하게
+	double center[2 * POINTGEN_NUM_CLUSTER];
+	for (int k = 0; k < POINTGEN_NUM_CLUSTER; k++)
+	{
+		uint32_t counter[4] = { (uint32_t) k, POINTGEN_STREAM_CLUSTER, 0, 0};
+		uint32_t u[4];
+
+		philox4x32( counter, seed, u);
+		center[2*k] = 1 + (range - 1) * (0.125 + 0.75 * pointgen_unit( u[0]));
+		center[2*k+1] = 1 + (range - 1) * (0.125 + 0.75 * pointgen_unit( u[1]));
+	}
+
+	if (num_point < POINTGEN_PAR_CUTOFF || num_thread < 1)
+		num_thread = 1;
+
+	pthread_t threads[num_thread];
+	t_pointgen_job jobs[num_thread];
+
+	for (int t = 0; t < num_thread; t++)
+	{
+		jobs[t] = (t_pointgen_job){ points, num_point * t / num_thread, num_point * (t + 1) / num_thread,
+			distribution, seed, stream, range, center};
+		if (t > 0)
+			pthread_create( &threads[t], NULL, pointgen_job, &jobs[t]);
+	}
+	pointgen_job( &jobs[0]);
+
+	for (int t = 1; t < num_thread; t++)
+		pthread_join( threads[t], NULL);
+}
+
+#endif